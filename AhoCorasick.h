@@ -0,0 +1,331 @@
+/// @file
+/// Defines the AhoCorasick object.
+#ifndef _SCOTTZ0R_AHO_CORASICK_INCLUDE_GUARD
+#define _SCOTTZ0R_AHO_CORASICK_INCLUDE_GUARD
+
+#include "StringSlice.h"
+#include "SliceArena.h"
+
+namespace scottz0r
+{
+    /// Aho-Corasick automaton for finding many patterns in one pass. Scanning cost depends on the haystack size
+    /// and the number of matches, not the number of patterns.
+    ///
+    /// States are numbered in breadth first order. The first dense_states states (the root and the shallowest
+    /// states, where most of the time is spent) have a full 256 entry transition row with failure transitions
+    /// already resolved. Deeper states store only their children, as sorted labels and targets packed together
+    /// by state, and fall back to failure links on a miss.
+    ///
+    /// All memory comes from a SliceArena. Building needs about 46 bytes per pattern byte while it runs, and the
+    /// finished automaton keeps about 21 bytes per state plus 1 KiB per dense state. This class does not throw
+    /// exceptions.
+    class AhoCorasick
+    {
+    public:
+        using size_type = StringSlice::size_type;
+
+        /// Construct an empty automaton that matches nothing.
+        AhoCorasick() noexcept
+            : m_states(0), m_dense_states(0), m_dense(nullptr), m_edge_begin(nullptr), m_labels(nullptr),
+            m_targets(nullptr), m_fail(nullptr), m_output(nullptr), m_dict(nullptr), m_pattern_sizes(nullptr)
+        {
+        }
+
+        /// Build the automaton from a list of patterns. Empty patterns are ignored. If a pattern appears more than
+        /// once, matches are reported with the index of its first occurrence. Returns false if the arena is too
+        /// small, in which case the automaton is left empty and the arena is returned to its previous mark.
+        bool build(const StringSlice* patterns, size_type count, SliceArena& arena, size_type dense_states = 64)
+            noexcept
+        {
+            *this = AhoCorasick();
+            size_t start_mark = arena.mark();
+
+            size_type max_states = 1;
+            for (size_type i = 0; i < count; ++i)
+            {
+                max_states += patterns[i].size();
+            }
+
+            if (!allocate(arena, max_states, count, dense_states) || !build_states(patterns, count, max_states, arena))
+            {
+                *this = AhoCorasick();
+                arena.release(start_mark);
+                return false;
+            }
+
+            return true;
+        }
+
+        /// @see build(const StringSlice*, size_type, SliceArena&, size_type).
+        template<size_type _Size>
+        bool build(const StringSlice(&patterns)[_Size], SliceArena& arena, size_type dense_states = 64) noexcept
+        {
+            return build(patterns, _Size, arena, dense_states);
+        }
+
+        /// Returns the number of states.
+        size_type state_count() const noexcept { return m_states; }
+
+        /// Call fn(size_type pattern, size_type position) for every match in the haystack, in order of where the
+        /// matches end. pattern is the index of the pattern in the build list and position is where the match
+        /// starts in the haystack. Overlapping matches are all reported.
+        template<typename Fn>
+        void find_all(const StringSlice& haystack, Fn&& fn) const noexcept
+        {
+            if (m_states == 0)
+            {
+                return;
+            }
+
+            uint32_t state = 0;
+            for (size_type i = 0; i < haystack.size(); ++i)
+            {
+                state = next_state(state, (uint8_t)haystack[i]);
+
+                uint32_t s = m_output[state] != no_value ? state : m_dict[state];
+                while (s != no_value)
+                {
+                    uint32_t pattern = m_output[s];
+                    fn((size_type)pattern, i + 1 - m_pattern_sizes[pattern]);
+                    s = m_dict[s];
+                }
+            }
+        }
+
+        /// Returns true if any pattern occurs in the haystack.
+        bool contains_any(const StringSlice& haystack) const noexcept
+        {
+            if (m_states == 0)
+            {
+                return false;
+            }
+
+            uint32_t state = 0;
+            for (size_type i = 0; i < haystack.size(); ++i)
+            {
+                state = next_state(state, (uint8_t)haystack[i]);
+                if (m_output[state] != no_value || m_dict[state] != no_value)
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+    private:
+        static constexpr uint32_t no_value = 0xFFFFFFFF;
+
+        uint32_t next_state(uint32_t state, uint8_t c) const noexcept
+        {
+            for (;;)
+            {
+                if (state < m_dense_states)
+                {
+                    return m_dense[(size_t)state * 256 + c];
+                }
+
+                for (uint32_t e = m_edge_begin[state]; e < m_edge_begin[state + 1]; ++e)
+                {
+                    if (m_labels[e] == c)
+                    {
+                        return m_targets[e];
+                    }
+                }
+
+                if (state == 0)
+                {
+                    return 0;
+                }
+
+                state = m_fail[state];
+            }
+        }
+
+        bool allocate(SliceArena& arena, size_type max_states, size_type count, size_type dense_states) noexcept
+        {
+            m_dense_states = dense_states < max_states ? dense_states : max_states;
+            m_edge_begin = arena.allocate<uint32_t>(max_states + 1);
+            m_labels = arena.allocate<uint8_t>(max_states);
+            m_targets = arena.allocate<uint32_t>(max_states);
+            m_fail = arena.allocate<uint32_t>(max_states);
+            m_output = arena.allocate<uint32_t>(max_states);
+            m_dict = arena.allocate<uint32_t>(max_states);
+            m_pattern_sizes = arena.allocate<uint32_t>(count);
+            m_dense = arena.allocate<uint32_t>((size_t)m_dense_states * 256);
+
+            return m_edge_begin && m_labels && m_targets && m_fail && m_output && m_dict &&
+                (m_pattern_sizes || count == 0) && (m_dense || m_dense_states == 0);
+        }
+
+        /// Build the trie in temporary arena memory, then write the final tables. Temporary memory is released
+        /// before returning.
+        bool build_states(const StringSlice* patterns, size_type count, size_type max_states, SliceArena& arena)
+            noexcept
+        {
+            size_t temp_mark = arena.mark();
+
+            // Trie in insertion order. Children are kept in a list sorted by label.
+            uint32_t* first_child = arena.allocate<uint32_t>(max_states);
+            uint32_t* next_sibling = arena.allocate<uint32_t>(max_states);
+            uint8_t* label = arena.allocate<uint8_t>(max_states);
+            uint32_t* output = arena.allocate<uint32_t>(max_states);
+            uint32_t* order = arena.allocate<uint32_t>(max_states);
+            uint32_t* new_id = arena.allocate<uint32_t>(max_states);
+            uint32_t* fail = arena.allocate<uint32_t>(max_states);
+
+            if (!first_child || !next_sibling || !label || !output || !order || !new_id || !fail)
+            {
+                return false;
+            }
+
+            uint32_t nodes = 1;
+            first_child[0] = no_value;
+            output[0] = no_value;
+
+            for (size_type p = 0; p < count; ++p)
+            {
+                m_pattern_sizes[p] = patterns[p].size();
+                if (patterns[p].empty())
+                {
+                    continue;
+                }
+
+                uint32_t node = 0;
+                for (size_type i = 0; i < patterns[p].size(); ++i)
+                {
+                    uint8_t c = (uint8_t)patterns[p][i];
+
+                    // Find the child, or the link to insert it at to keep the list sorted.
+                    uint32_t* link = &first_child[node];
+                    while (*link != no_value && label[*link] < c)
+                    {
+                        link = &next_sibling[*link];
+                    }
+
+                    if (*link == no_value || label[*link] != c)
+                    {
+                        uint32_t child = nodes++;
+                        first_child[child] = no_value;
+                        next_sibling[child] = *link;
+                        label[child] = c;
+                        output[child] = no_value;
+                        *link = child;
+                    }
+
+                    node = *link;
+                }
+
+                if (output[node] == no_value)
+                {
+                    output[node] = (uint32_t)p;
+                }
+            }
+
+            // Breadth first order, with failure links computed along the way. The failure target of a node is
+            // always shallower, so it is already final when the node is reached.
+            uint32_t head = 0;
+            uint32_t tail = 0;
+            order[tail++] = 0;
+            fail[0] = 0;
+
+            while (head < tail)
+            {
+                uint32_t node = order[head++];
+                new_id[node] = head - 1;
+
+                for (uint32_t child = first_child[node]; child != no_value; child = next_sibling[child])
+                {
+                    order[tail++] = child;
+
+                    if (node == 0)
+                    {
+                        fail[child] = 0;
+                        continue;
+                    }
+
+                    uint32_t f = fail[node];
+                    uint32_t target;
+                    while ((target = trie_child(first_child, next_sibling, label, f, label[child])) == no_value && f != 0)
+                    {
+                        f = fail[f];
+                    }
+
+                    fail[child] = target == no_value ? 0 : target;
+                }
+            }
+
+            // Write the final tables in breadth first order.
+            m_states = nodes;
+            if (m_dense_states > m_states)
+            {
+                m_dense_states = m_states;
+            }
+
+            uint32_t edge = 0;
+            for (uint32_t s = 0; s < nodes; ++s)
+            {
+                uint32_t node = order[s];
+                m_fail[s] = new_id[fail[node]];
+                m_output[s] = output[node];
+                m_dict[s] = s == 0 ? no_value : (m_output[m_fail[s]] != no_value ? m_fail[s] : m_dict[m_fail[s]]);
+
+                m_edge_begin[s] = edge;
+                for (uint32_t child = first_child[node]; child != no_value; child = next_sibling[child])
+                {
+                    m_labels[edge] = label[child];
+                    m_targets[edge] = new_id[child];
+                    ++edge;
+                }
+
+                if (s < m_dense_states)
+                {
+                    // The failure state is shallower, so its row is already filled in.
+                    uint32_t* row = m_dense + (size_t)s * 256;
+                    const uint32_t* fail_row = m_dense + (size_t)m_fail[s] * 256;
+                    for (unsigned int c = 0; c < 256; ++c)
+                    {
+                        row[c] = s == 0 ? 0 : fail_row[c];
+                    }
+
+                    for (uint32_t e = m_edge_begin[s]; e < edge; ++e)
+                    {
+                        row[m_labels[e]] = m_targets[e];
+                    }
+                }
+            }
+
+            m_edge_begin[nodes] = edge;
+
+            arena.release(temp_mark);
+            return true;
+        }
+
+        static uint32_t trie_child(const uint32_t* first_child, const uint32_t* next_sibling, const uint8_t* label,
+            uint32_t node, uint8_t c) noexcept
+        {
+            for (uint32_t child = first_child[node]; child != no_value && label[child] <= c; child = next_sibling[child])
+            {
+                if (label[child] == c)
+                {
+                    return child;
+                }
+            }
+
+            return no_value;
+        }
+
+        uint32_t m_states;
+        uint32_t m_dense_states;
+        uint32_t* m_dense;
+        uint32_t* m_edge_begin;
+        uint8_t* m_labels;
+        uint32_t* m_targets;
+        uint32_t* m_fail;
+        uint32_t* m_output;
+        uint32_t* m_dict;
+        uint32_t* m_pattern_sizes;
+    };
+}
+
+#endif // _SCOTTZ0R_AHO_CORASICK_INCLUDE_GUARD
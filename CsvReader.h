@@ -0,0 +1,183 @@
+/// @file
+/// Defines the CsvReader object.
+#ifndef _SCOTTZ0R_CSV_READER_INCLUDE_GUARD
+#define _SCOTTZ0R_CSV_READER_INCLUDE_GUARD
+
+#include "StringSlice.h"
+#include "SliceBits.h"
+
+namespace scottz0r
+{
+    /// A single field returned by CsvReader. The value is a slice into the reader's buffer. Quoted fields have the
+    /// surrounding quotes removed, but escaped quotes ("") are left as-is and flagged with needs_unescape.
+    struct CsvField
+    {
+        StringSlice value;
+        bool quoted = false;
+        bool needs_unescape = false;
+
+        /// @see unescape_to.
+        template<StringSlice::size_type _Size>
+        inline StringSlice::size_type unescape_to(char(&dst)[_Size]) const noexcept
+        {
+            return unescape_to(dst, _Size);
+        }
+
+        /// Copy the field to a character buffer, replacing escaped quotes ("") with a single quote. This will
+        /// always null terminate. Returns the number of characters copied, not including the null terminator. If
+        /// the destination buffer is too small, the result will be truncated.
+        StringSlice::size_type unescape_to(char* dst, StringSlice::size_type dst_size) const noexcept
+        {
+            if (!dst || dst_size == 0)
+            {
+                return 0;
+            }
+
+            StringSlice::size_type out = 0;
+            for (StringSlice::size_type i = 0; i < value.size() && out < dst_size - 1; ++i)
+            {
+                dst[out++] = value[i];
+
+                // Skip the second quote of an escaped pair.
+                if (needs_unescape && value[i] == '"' && value.at(i + 1) == '"')
+                {
+                    ++i;
+                }
+            }
+
+            dst[out] = 0;
+            return out;
+        }
+    };
+
+    /// Reads rows of fields from a CSV (or TSV) buffer without copying. Delimiters and newlines inside quoted
+    /// fields are handled per RFC 4180. The buffer is scanned in 64 byte blocks: each block is turned into
+    /// bitmasks of quotes, delimiters and newlines, and a prefix XOR of the quote mask removes the structural
+    /// characters that are inside quotes. Fields are then read by walking the set bits of the remaining mask.
+    /// This class does not throw exceptions.
+    class CsvReader
+    {
+    public:
+        using size_type = StringSlice::size_type;
+
+        /// Construct a reader over a buffer. The reader has the same lifetime as the buffer.
+        CsvReader(const StringSlice& buffer, char delimiter = ',') noexcept
+            : m_buffer(buffer), m_delimiter(delimiter), m_pos(0), m_block(0), m_next_block(0), m_mask(0),
+            m_in_quote(0)
+        {
+        }
+
+        /// Returns true if all rows have been read.
+        bool at_end() const noexcept { return m_pos >= m_buffer.size(); }
+
+        /// @see read_row.
+        template<size_type _Size>
+        inline size_type read_row(CsvField(&fields)[_Size]) noexcept
+        {
+            return read_row(fields, _Size);
+        }
+
+        /// Read the next row into the given field array. Returns the number of fields stored. Returns 0 when there
+        /// are no more rows. Fields beyond max_fields are skipped. An empty line is read as a single empty field.
+        /// A trailing carriage return before the newline is not included in the last field.
+        size_type read_row(CsvField* fields, size_type max_fields) noexcept
+        {
+            if (at_end())
+            {
+                return 0;
+            }
+
+            size_type count = 0;
+            for (;;)
+            {
+                size_type idx = next_structural();
+                size_type end = idx == StringSlice::npos ? m_buffer.size() : idx;
+                bool end_of_row = idx == StringSlice::npos || m_buffer[idx] == '\n';
+
+                if (fields && count < max_fields)
+                {
+                    fields[count++] = make_field(m_pos, end, end_of_row);
+                }
+
+                m_pos = end + 1;
+
+                if (end_of_row)
+                {
+                    break;
+                }
+            }
+
+            return count;
+        }
+
+    private:
+        /// Returns the index of the next delimiter or newline that is not inside quotes, or npos.
+        size_type next_structural() noexcept
+        {
+            while (m_mask == 0)
+            {
+                if (m_next_block >= m_buffer.size())
+                {
+                    return StringSlice::npos;
+                }
+
+                load_block(m_next_block);
+            }
+
+            size_type idx = m_block + bits::ctz64(m_mask);
+            m_mask &= m_mask - 1;
+            return idx;
+        }
+
+        void load_block(size_type start) noexcept
+        {
+            size_type remaining = m_buffer.size() - start;
+            unsigned int len = remaining < bits::block_size ? remaining : bits::block_size;
+            const char* p = m_buffer.data() + start;
+
+            bits::ByteBlock block(p, len);
+            uint64_t quotes = block.eq('"');
+            uint64_t structural = block.eq(m_delimiter) | block.eq('\n');
+
+            uint64_t inside = bits::prefix_xor64(quotes) ^ m_in_quote;
+
+            // Carry the quote state of the last byte into the next block (all ones or all zeros).
+            m_in_quote = (uint64_t)0 - (inside >> 63);
+
+            m_mask = structural & ~inside;
+            m_block = start;
+            m_next_block = start + len;
+        }
+
+        CsvField make_field(size_type start, size_type end, bool end_of_row) const noexcept
+        {
+            CsvField field;
+            StringSlice raw = m_buffer.substr(start, end - start);
+
+            if (end_of_row && !raw.empty() && raw[raw.size() - 1] == '\r')
+            {
+                raw = raw.substr(0, raw.size() - 1);
+            }
+
+            if (raw.size() >= 2 && raw[0] == '"' && raw[raw.size() - 1] == '"')
+            {
+                field.quoted = true;
+                raw = raw.substr(1, raw.size() - 2);
+                field.needs_unescape = raw.find('"') != StringSlice::npos;
+            }
+
+            field.value = raw;
+            return field;
+        }
+
+        StringSlice m_buffer;
+        char m_delimiter;
+        size_type m_pos;
+        size_type m_block;
+        size_type m_next_block;
+        uint64_t m_mask;
+        uint64_t m_in_quote;
+    };
+}
+
+#endif // _SCOTTZ0R_CSV_READER_INCLUDE_GUARD
@@ -0,0 +1,247 @@
+/// @file
+/// Bit-parallel edit distance and approximate matching of StringSlice objects.
+#ifndef _SCOTTZ0R_EDIT_DISTANCE_INCLUDE_GUARD
+#define _SCOTTZ0R_EDIT_DISTANCE_INCLUDE_GUARD
+
+#include "StringSlice.h"
+
+namespace scottz0r
+{
+    namespace detail
+    {
+        /// Most 64 character blocks in a pattern. Longer patterns are not supported.
+        static constexpr unsigned int edit_max_words = 64;
+
+        /// Myers' bit-parallel edit distance. The dynamic programming matrix has a row per pattern character and
+        /// a column per text character. Each column is kept as bit vectors of its vertical differences (+1 or
+        /// -1 from the row above), 64 rows per word, and the whole column is advanced by one text character with
+        /// a few word operations per block (Hyyro's block version for patterns longer than 64).
+        ///
+        /// Patterns of one word use a 2 KiB table of match masks. Longer patterns compute each block's mask from
+        /// the pattern bytes 8 at a time, so the state stays about 3 KiB of stack for patterns up to 4096 bytes.
+        class MyersMatcher
+        {
+        public:
+            using size_type = StringSlice::size_type;
+
+            explicit MyersMatcher(const StringSlice& pattern) noexcept
+                : m_pattern(pattern), m_words((pattern.size() + 63) / 64), m_score(0)
+            {
+                if (m_words == 1)
+                {
+                    memset(m_peq, 0, sizeof(m_peq));
+                    for (size_type i = 0; i < pattern.size(); ++i)
+                    {
+                        m_peq[(unsigned char)pattern[i]] |= 1ull << i;
+                    }
+                }
+
+                m_last_bit = pattern.size() > 0 ? 1ull << ((pattern.size() - 1) % 64) : 0;
+            }
+
+            /// Returns true if the pattern is supported.
+            bool valid() const noexcept { return m_words <= edit_max_words; }
+
+            /// Start a new text. In search mode a match can start anywhere in the text, otherwise it starts at
+            /// the beginning.
+            void reset(bool search) noexcept
+            {
+                for (unsigned int b = 0; b < m_words; ++b)
+                {
+                    m_pv[b] = ~0ull;
+                    m_mv[b] = 0;
+                }
+
+                m_top = search ? 0 : 1;
+                m_score = m_pattern.size();
+            }
+
+            /// Advance by one text character. Returns the edit distance between the whole pattern and the text so
+            /// far, or in search mode, the smallest distance to any text suffix ending here.
+            size_type step(char c) noexcept
+            {
+                // Horizontal difference carried from the block above, starting with row 0.
+                int carry = m_top;
+                for (unsigned int b = 0; b < m_words; ++b)
+                {
+                    uint64_t eq = m_words == 1 ? m_peq[(unsigned char)c] : block_eq(b, c);
+                    uint64_t pv = m_pv[b];
+                    uint64_t mv = m_mv[b];
+
+                    uint64_t carry_pos = carry > 0 ? 1 : 0;
+                    uint64_t carry_neg = carry < 0 ? 1 : 0;
+                    uint64_t xv = eq | mv;
+                    eq |= carry_neg;
+                    uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+                    uint64_t ph = mv | ~(xh | pv);
+                    uint64_t mh = pv & xh;
+
+                    uint64_t out_bit = b + 1 == m_words ? m_last_bit : 1ull << 63;
+                    carry = (ph & out_bit) ? 1 : ((mh & out_bit) ? -1 : 0);
+
+                    ph = (ph << 1) | carry_pos;
+                    mh = (mh << 1) | carry_neg;
+                    m_pv[b] = mh | ~(xv | ph);
+                    m_mv[b] = ph & xv;
+                }
+
+                m_score += carry;
+                return m_score;
+            }
+
+        private:
+            /// Little endian load of up to 8 bytes, zero filled.
+            static uint64_t load_le(const char* p, unsigned int len) noexcept
+            {
+                uint64_t v = 0;
+                for (unsigned int i = 0; i < len; ++i)
+                {
+                    v |= (uint64_t)(unsigned char)p[i] << (8 * i);
+                }
+
+                return v;
+            }
+
+            /// Match mask of c in block b of the pattern.
+            uint64_t block_eq(unsigned int b, char c) const noexcept
+            {
+                size_type begin = b * 64;
+                size_type end = begin + 64 < m_pattern.size() ? begin + 64 : m_pattern.size();
+                uint64_t broadcast = 0x0101010101010101ull * (unsigned char)c;
+                uint64_t eq = 0;
+                for (size_type i = begin; i < end; i += 8)
+                {
+                    unsigned int len = end - i < 8 ? end - i : 8;
+                    uint64_t found = bits::zero_bytes_exact(load_le(m_pattern.data() + i, len) ^ broadcast);
+
+                    // Gather the high bit of each byte into 8 bits, byte i to bit i.
+                    uint64_t byte_mask = ((found >> 7) * 0x0102040810204080ull) >> 56;
+                    eq |= (byte_mask & ((1ull << len) - 1)) << (i - begin);
+                }
+
+                return eq;
+            }
+
+            StringSlice m_pattern;
+            unsigned int m_words;
+            int m_top;
+            size_type m_score;
+            uint64_t m_last_bit;
+            uint64_t m_peq[256];
+            uint64_t m_pv[edit_max_words];
+            uint64_t m_mv[edit_max_words];
+        };
+    }
+
+    /// Returns the Levenshtein distance between a and b: the fewest single character insertions, deletions and
+    /// substitutions that turn one into the other. Returns npos if both strings are longer than 4096 bytes.
+    inline StringSlice::size_type levenshtein(const StringSlice& a, const StringSlice& b) noexcept
+    {
+        // The distance is symmetric, so the shorter string is the pattern.
+        const StringSlice& pattern = a.size() <= b.size() ? a : b;
+        const StringSlice& text = a.size() <= b.size() ? b : a;
+        if (pattern.empty())
+        {
+            return text.size();
+        }
+
+        detail::MyersMatcher matcher(pattern);
+        if (!matcher.valid())
+        {
+            return StringSlice::npos;
+        }
+
+        matcher.reset(false);
+        StringSlice::size_type distance = pattern.size();
+        for (StringSlice::size_type i = 0; i < text.size(); ++i)
+        {
+            distance = matcher.step(text[i]);
+        }
+
+        return distance;
+    }
+
+    /// Returns the Levenshtein distance between a and b if it is at most k, otherwise k + 1, so k = npos gives
+    /// the exact distance. Stops as soon as the distance is known to be over k, so comparing against a small k
+    /// is cheap even for long strings. Returns npos if both strings are longer than 4096 bytes, unless their
+    /// sizes alone differ by more than k.
+    inline StringSlice::size_type levenshtein_bounded(const StringSlice& a, const StringSlice& b,
+        StringSlice::size_type k) noexcept
+    {
+        const StringSlice::size_type over = k < StringSlice::npos ? k + 1 : StringSlice::npos;
+        const StringSlice& pattern = a.size() <= b.size() ? a : b;
+        const StringSlice& text = a.size() <= b.size() ? b : a;
+        if (text.size() - pattern.size() > k)
+        {
+            return over;
+        }
+
+        if (pattern.empty())
+        {
+            return text.size();
+        }
+
+        detail::MyersMatcher matcher(pattern);
+        if (!matcher.valid())
+        {
+            return StringSlice::npos;
+        }
+
+        matcher.reset(false);
+        StringSlice::size_type distance = pattern.size();
+        for (StringSlice::size_type i = 0; i < text.size(); ++i)
+        {
+            distance = matcher.step(text[i]);
+
+            // Each remaining text character lowers the distance by at most one.
+            StringSlice::size_type remaining = text.size() - i - 1;
+            if (distance > remaining && distance - remaining > k)
+            {
+                return over;
+            }
+        }
+
+        return distance <= k ? distance : over;
+    }
+
+    /// Finds the first place in haystack where pattern occurs with at most k edits. Returns the end of the match
+    /// (one past its last character) or npos if there is none. If distance is given, it receives the edits of
+    /// the match. Returns npos if pattern is longer than 4096 bytes.
+    inline StringSlice::size_type fuzzy_find(const StringSlice& haystack, const StringSlice& pattern,
+        StringSlice::size_type k, StringSlice::size_type* distance = nullptr) noexcept
+    {
+        // Deleting the whole pattern matches before the first character.
+        if (pattern.size() <= k)
+        {
+            if (distance)
+            {
+                *distance = pattern.size();
+            }
+            return 0;
+        }
+
+        detail::MyersMatcher matcher(pattern);
+        if (!matcher.valid())
+        {
+            return StringSlice::npos;
+        }
+
+        matcher.reset(true);
+        for (StringSlice::size_type i = 0; i < haystack.size(); ++i)
+        {
+            StringSlice::size_type edits = matcher.step(haystack[i]);
+            if (edits <= k)
+            {
+                if (distance)
+                {
+                    *distance = edits;
+                }
+                return i + 1;
+            }
+        }
+
+        return StringSlice::npos;
+    }
+}
+
+#endif // _SCOTTZ0R_EDIT_DISTANCE_INCLUDE_GUARD
@@ -0,0 +1,291 @@
+/// @file
+/// Defines the GlobPattern object.
+#ifndef _SCOTTZ0R_GLOB_PATTERN_INCLUDE_GUARD
+#define _SCOTTZ0R_GLOB_PATTERN_INCLUDE_GUARD
+
+#include "StringSlice.h"
+
+namespace scottz0r
+{
+    /// Compiled glob pattern, such as "metrics.*.cpu" or "log-??-*.txt". '*' matches any run of bytes (including
+    /// none), '?' matches exactly one byte, and a backslash makes the next character literal. There is no special
+    /// handling of path separators.
+    ///
+    /// The pattern is split at the stars into segments. The first segment is compared at the start of the key and
+    /// the last at the end, so literal prefixes and suffixes are checked before any searching is done. Each
+    /// middle segment is found at its leftmost position after the previous one, which is always correct for
+    /// star-only globs, so matching never backtracks and runs in about the time of one find per segment. The
+    /// search uses StringSlice::find on the longest literal run of the segment and then checks the rest of it.
+    ///
+    /// The pattern text is not copied and must outlive the GlobPattern. Compiling and matching do not allocate.
+    /// This class does not throw exceptions.
+    class GlobPattern
+    {
+    public:
+        using size_type = StringSlice::size_type;
+
+        /// Maximum number of segments (runs between stars, plus one).
+        static constexpr size_type max_segments = 16;
+
+        /// Construct an invalid pattern that matches nothing.
+        GlobPattern() noexcept
+            : m_segment_count(0), m_min_size(0), m_has_star(false), m_valid(false)
+        {
+        }
+
+        /// Compile a pattern. If the pattern ends with a lone backslash or has more than max_segments segments,
+        /// valid() will return false and nothing will match.
+        explicit GlobPattern(const StringSlice& pattern) noexcept
+            : GlobPattern()
+        {
+            m_pattern = pattern;
+            m_valid = compile();
+            if (!m_valid)
+            {
+                m_segment_count = 0;
+            }
+        }
+
+        /// Returns true if the pattern was compiled.
+        bool valid() const noexcept { return m_valid; }
+
+        /// Returns the pattern text.
+        const StringSlice& pattern() const noexcept { return m_pattern; }
+
+        /// Returns the minimum key size that can match.
+        size_type min_size() const noexcept { return m_min_size; }
+
+        /// Returns the literal text every match must start with: the pattern up to the first wildcard or escape.
+        /// Useful to bucket many patterns by prefix.
+        StringSlice literal_prefix() const noexcept
+        {
+            size_type i = 0;
+            while (i < m_pattern.size() && !is_special(m_pattern[i]))
+            {
+                ++i;
+            }
+
+            return m_pattern.substr(0, i);
+        }
+
+        /// Returns the literal text every match must end with: the pattern after the last wildcard or escape.
+        StringSlice literal_suffix() const noexcept
+        {
+            size_type i = m_pattern.size();
+            while (i > 0 && !is_special(m_pattern[i - 1]))
+            {
+                --i;
+            }
+
+            // A pattern with no special characters is all prefix and all suffix.
+            return m_pattern.substr(i);
+        }
+
+        /// Returns true if the whole key matches the pattern.
+        bool matches(const StringSlice& key) const noexcept
+        {
+            if (!m_valid || key.size() < m_min_size)
+            {
+                return false;
+            }
+
+            const Segment& head = m_segments[0];
+            if (!m_has_star)
+            {
+                return key.size() == head.size && segment_matches(head, key.data());
+            }
+
+            const Segment& tail = m_segments[m_segment_count - 1];
+            size_type end = key.size() - tail.size;
+            if (!segment_matches(head, key.data()) || !segment_matches(tail, key.data() + end))
+            {
+                return false;
+            }
+
+            size_type pos = head.size;
+            for (size_type s = 1; s + 1 < m_segment_count; ++s)
+            {
+                size_type found = find_segment(m_segments[s], key, pos, end);
+                if (found == StringSlice::npos)
+                {
+                    return false;
+                }
+
+                pos = found + m_segments[s].size;
+            }
+
+            return true;
+        }
+
+    private:
+        /// A run of the pattern between stars. The anchor is its longest run of plain characters, which is what
+        /// gets passed to find when the segment is searched for.
+        struct Segment
+        {
+            size_type begin;        ///< Offset of the segment in the pattern.
+            size_type end;          ///< Offset one past the segment in the pattern.
+            size_type size;         ///< Number of key bytes the segment matches.
+            size_type anchor;       ///< Offset of the anchor in the pattern.
+            size_type anchor_size;  ///< Size of the anchor.
+            size_type anchor_shift; ///< Number of key bytes the segment matches before the anchor.
+        };
+
+        static bool is_special(char c) noexcept
+        {
+            return c == '*' || c == '?' || c == '\\';
+        }
+
+        bool compile() noexcept
+        {
+            size_type begin = 0;
+            for (size_type i = 0; i <= m_pattern.size(); ++i)
+            {
+                if (i < m_pattern.size() && m_pattern[i] == '\\')
+                {
+                    if (++i == m_pattern.size())
+                    {
+                        return false;
+                    }
+
+                    continue;
+                }
+
+                if (i < m_pattern.size() && m_pattern[i] != '*')
+                {
+                    continue;
+                }
+
+                // End of a segment. Empty middle segments (from "**") are dropped, but the first and last are always
+                // kept so they can be compared at the ends of the key.
+                bool last = i == m_pattern.size();
+                if (i > begin || m_segment_count == 0 || last)
+                {
+                    if (m_segment_count == max_segments)
+                    {
+                        return false;
+                    }
+
+                    add_segment(begin, i);
+                }
+
+                m_has_star = m_has_star || !last;
+                begin = i + 1;
+            }
+
+            return true;
+        }
+
+        void add_segment(size_type begin, size_type end) noexcept
+        {
+            Segment& seg = m_segments[m_segment_count++];
+            seg.begin = begin;
+            seg.end = end;
+            seg.size = 0;
+            seg.anchor = begin;
+            seg.anchor_size = 0;
+            seg.anchor_shift = 0;
+
+            size_type run = begin;
+            size_type run_shift = 0;
+            for (size_type i = begin; i < end; ++i)
+            {
+                char c = m_pattern[i];
+                if (c == '?' || c == '\\')
+                {
+                    i += c == '\\';
+                    run = i + 1;
+                    run_shift = seg.size + 1;
+                }
+                else if (i + 1 - run > seg.anchor_size)
+                {
+                    seg.anchor = run;
+                    seg.anchor_size = i + 1 - run;
+                    seg.anchor_shift = run_shift;
+                }
+
+                ++seg.size;
+            }
+
+            m_min_size += seg.size;
+        }
+
+        /// Compare a segment against key bytes starting at k. The caller checks that enough bytes are left.
+        bool segment_matches(const Segment& seg, const char* k) const noexcept
+        {
+            const char* p = m_pattern.data();
+            if (seg.anchor_size == seg.size)
+            {
+                return memcmp(p + seg.begin, k, seg.size) == 0;
+            }
+
+            for (size_type i = seg.begin; i < seg.end; ++i, ++k)
+            {
+                char c = p[i];
+                if (c == '?')
+                {
+                    continue;
+                }
+
+                if (c == '\\')
+                {
+                    c = p[++i];
+                }
+
+                if (c != *k)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        /// Returns the leftmost position in [pos, end) where the segment matches and fits before end.
+        size_type find_segment(const Segment& seg, const StringSlice& key, size_type pos, size_type end) const noexcept
+        {
+            if (seg.anchor_size == 0)
+            {
+                // Only '?' and escapes that did not form a run; try each position.
+                for (; pos + seg.size <= end; ++pos)
+                {
+                    if (segment_matches(seg, key.data() + pos))
+                    {
+                        return pos;
+                    }
+                }
+
+                return StringSlice::npos;
+            }
+
+            StringSlice window = key.substr(0, end);
+            StringSlice anchor = m_pattern.substr(seg.anchor, seg.anchor_size);
+            size_type from = pos + seg.anchor_shift;
+
+            for (;;)
+            {
+                size_type hit = window.find(anchor, from);
+                if (hit == StringSlice::npos || hit - seg.anchor_shift + seg.size > end)
+                {
+                    return StringSlice::npos;
+                }
+
+                size_type start = hit - seg.anchor_shift;
+                if (segment_matches(seg, key.data() + start))
+                {
+                    return start;
+                }
+
+                from = hit + 1;
+            }
+        }
+
+        StringSlice m_pattern;
+        Segment m_segments[max_segments];
+        size_type m_segment_count;
+        size_type m_min_size;
+        bool m_has_star;
+        bool m_valid;
+    };
+}
+
+#endif // _SCOTTZ0R_GLOB_PATTERN_INCLUDE_GUARD
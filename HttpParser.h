@@ -0,0 +1,638 @@
+/// @file
+/// Defines zero-copy HTTP/1.x head parsing and chunked transfer-encoding decoding.
+#ifndef _SCOTTZ0R_HTTP_PARSER_INCLUDE_GUARD
+#define _SCOTTZ0R_HTTP_PARSER_INCLUDE_GUARD
+
+#include "StringSlice.h"
+#include "SliceBits.h"
+
+namespace scottz0r
+{
+    /// Returned by the parse functions when the head is malformed.
+    static constexpr int http_parse_error = -1;
+
+    /// Returned by the parse functions when the head is not complete yet.
+    static constexpr int http_parse_incomplete = -2;
+
+    /// A header name and value. The value does not include leading or trailing whitespace.
+    struct HttpHeader
+    {
+        StringSlice name;
+        StringSlice value;
+    };
+
+    /// Parsed request head. All slices point into the parsed buffer. Holds at most MaxHeaders headers.
+    template<StringSlice::size_type MaxHeaders>
+    struct HttpRequest
+    {
+        StringSlice method;
+        StringSlice path;
+        int minor_version = 0;
+        HttpHeader headers[MaxHeaders];
+        StringSlice::size_type num_headers = 0;
+    };
+
+    /// Parsed response head. All slices point into the parsed buffer. Holds at most MaxHeaders headers.
+    template<StringSlice::size_type MaxHeaders>
+    struct HttpResponse
+    {
+        int minor_version = 0;
+        int status = 0;
+        StringSlice reason;
+        HttpHeader headers[MaxHeaders];
+        StringSlice::size_type num_headers = 0;
+    };
+
+    namespace detail
+    {
+        /// Returns true if c is a token character (RFC 7230 tchar).
+        inline bool is_http_token_char(char c) noexcept
+        {
+            if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9'))
+            {
+                return true;
+            }
+
+            switch (c)
+            {
+            case '!': case '#': case '$': case '%': case '&': case '\'': case '*': case '+':
+            case '-': case '.': case '^': case '_': case '`': case '|': case '~':
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        /// Returns the first byte in [p, end) that is less than limit or is DEL (0x7f), or end if there is none.
+        /// Checks 8 bytes at a time with a SWAR range check before falling back to a byte loop. limit must be at
+        /// most 0x80.
+        inline const char* http_find_ctl(const char* p, const char* end, unsigned char limit) noexcept
+        {
+            const uint64_t ones = 0x0101010101010101ull;
+            const uint64_t highs = 0x8080808080808080ull;
+
+            while (end - p >= 8)
+            {
+                uint64_t x = bits::load_u64(p);
+                uint64_t del = x ^ (ones * 0x7f);
+                uint64_t below = (x - ones * limit) & ~x;
+                uint64_t is_del = (del - ones) & ~del;
+
+                if ((below | is_del) & highs)
+                {
+                    break;
+                }
+
+                p += 8;
+            }
+
+            while (p < end)
+            {
+                unsigned char u = (unsigned char)*p;
+                if (u < limit || u == 0x7f)
+                {
+                    return p;
+                }
+
+                ++p;
+            }
+
+            return end;
+        }
+
+        /// Parse a CRLF or bare LF. Returns 0 on success.
+        inline int http_parse_eol(const char*& p, const char* end) noexcept
+        {
+            if (p == end)
+            {
+                return http_parse_incomplete;
+            }
+
+            if (*p == '\r')
+            {
+                ++p;
+                if (p == end)
+                {
+                    return http_parse_incomplete;
+                }
+            }
+
+            if (*p != '\n')
+            {
+                return http_parse_error;
+            }
+
+            ++p;
+            return 0;
+        }
+
+        /// Parse "HTTP/1.x". Returns 0 on success.
+        inline int http_parse_version(const char*& p, const char* end, int& minor_version) noexcept
+        {
+            const char prefix[] = "HTTP/1.";
+            for (unsigned int i = 0; i < sizeof(prefix) - 1; ++i, ++p)
+            {
+                if (p == end)
+                {
+                    return http_parse_incomplete;
+                }
+
+                if (*p != prefix[i])
+                {
+                    return http_parse_error;
+                }
+            }
+
+            if (p == end)
+            {
+                return http_parse_incomplete;
+            }
+
+            if (*p < '0' || *p > '9')
+            {
+                return http_parse_error;
+            }
+
+            minor_version = *p - '0';
+            ++p;
+            return 0;
+        }
+
+        /// Parse header lines up to and including the empty line that ends the head. Returns 0 on success.
+        inline int http_parse_headers(const char*& p, const char* end, HttpHeader* headers,
+            StringSlice::size_type max_headers, StringSlice::size_type& num_headers) noexcept
+        {
+            num_headers = 0;
+
+            for (;;)
+            {
+                if (p == end)
+                {
+                    return http_parse_incomplete;
+                }
+
+                if (*p == '\r' || *p == '\n')
+                {
+                    return http_parse_eol(p, end);
+                }
+
+                if (num_headers == max_headers)
+                {
+                    return http_parse_error;
+                }
+
+                const char* name = p;
+                while (p < end && is_http_token_char(*p))
+                {
+                    ++p;
+                }
+
+                if (p == end)
+                {
+                    return http_parse_incomplete;
+                }
+
+                if (*p != ':' || p == name)
+                {
+                    return http_parse_error;
+                }
+
+                StringSlice name_slice(name, (StringSlice::size_type)(p - name));
+                ++p;
+
+                while (p < end && (*p == ' ' || *p == '\t'))
+                {
+                    ++p;
+                }
+
+                const char* value = p;
+                for (;;)
+                {
+                    p = http_find_ctl(p, end, 0x20);
+                    if (p == end)
+                    {
+                        return http_parse_incomplete;
+                    }
+
+                    if (*p != '\t')
+                    {
+                        break;
+                    }
+
+                    ++p;
+                }
+
+                const char* value_end = p;
+                int res = http_parse_eol(p, end);
+                if (res != 0)
+                {
+                    return res;
+                }
+
+                while (value_end > value && (value_end[-1] == ' ' || value_end[-1] == '\t'))
+                {
+                    --value_end;
+                }
+
+                headers[num_headers].name = name_slice;
+                headers[num_headers].value = StringSlice(value, (StringSlice::size_type)(value_end - value));
+                ++num_headers;
+            }
+        }
+
+        /// Returns true if the buffer contains the blank line that ends a head. Only the bytes from near
+        /// last_size onward are checked, because the caller has already checked the bytes before it.
+        inline bool http_head_complete(const StringSlice& buffer, StringSlice::size_type last_size) noexcept
+        {
+            StringSlice::size_type i = last_size < 3 ? 0 : last_size - 3;
+
+            while ((i = buffer.find('\n', i)) != StringSlice::npos)
+            {
+                ++i;
+                if (buffer.at(i) == '\n' || (buffer.at(i) == '\r' && buffer.at(i + 1) == '\n'))
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        inline int http_parse_request(const StringSlice& buffer, StringSlice& method, StringSlice& path,
+            int& minor_version, HttpHeader* headers, StringSlice::size_type max_headers,
+            StringSlice::size_type& num_headers, StringSlice::size_type last_size) noexcept
+        {
+            if (last_size != 0 && !http_head_complete(buffer, last_size))
+            {
+                return http_parse_incomplete;
+            }
+
+            const char* p = buffer.data();
+            const char* end = p + buffer.size();
+
+            // Skip an empty line before the request line (RFC 7230 3.5).
+            if (p < end && (*p == '\r' || *p == '\n'))
+            {
+                int res = http_parse_eol(p, end);
+                if (res != 0)
+                {
+                    return res;
+                }
+            }
+
+            const char* start = p;
+            while (p < end && is_http_token_char(*p))
+            {
+                ++p;
+            }
+
+            if (p == end)
+            {
+                return http_parse_incomplete;
+            }
+
+            if (*p != ' ' || p == start)
+            {
+                return http_parse_error;
+            }
+
+            method = StringSlice(start, (StringSlice::size_type)(p - start));
+            start = ++p;
+
+            p = http_find_ctl(p, end, 0x21);
+            if (p == end)
+            {
+                return http_parse_incomplete;
+            }
+
+            if (*p != ' ' || p == start)
+            {
+                return http_parse_error;
+            }
+
+            path = StringSlice(start, (StringSlice::size_type)(p - start));
+            ++p;
+
+            int res = http_parse_version(p, end, minor_version);
+            if (res == 0)
+            {
+                res = http_parse_eol(p, end);
+            }
+
+            if (res == 0)
+            {
+                res = http_parse_headers(p, end, headers, max_headers, num_headers);
+            }
+
+            return res == 0 ? (int)(p - buffer.data()) : res;
+        }
+
+        inline int http_parse_response(const StringSlice& buffer, int& minor_version, int& status,
+            StringSlice& reason, HttpHeader* headers, StringSlice::size_type max_headers,
+            StringSlice::size_type& num_headers, StringSlice::size_type last_size) noexcept
+        {
+            if (last_size != 0 && !http_head_complete(buffer, last_size))
+            {
+                return http_parse_incomplete;
+            }
+
+            const char* p = buffer.data();
+            const char* end = p + buffer.size();
+
+            int res = http_parse_version(p, end, minor_version);
+            if (res != 0)
+            {
+                return res;
+            }
+
+            if (p == end)
+            {
+                return http_parse_incomplete;
+            }
+
+            if (*p != ' ')
+            {
+                return http_parse_error;
+            }
+
+            ++p;
+            status = 0;
+            for (int i = 0; i < 3; ++i, ++p)
+            {
+                if (p == end)
+                {
+                    return http_parse_incomplete;
+                }
+
+                if (*p < '0' || *p > '9')
+                {
+                    return http_parse_error;
+                }
+
+                status = status * 10 + (*p - '0');
+            }
+
+            // The reason phrase is optional.
+            const char* start = p;
+            if (p < end && *p == ' ')
+            {
+                start = ++p;
+                for (;;)
+                {
+                    p = http_find_ctl(p, end, 0x20);
+                    if (p == end || *p != '\t')
+                    {
+                        break;
+                    }
+
+                    ++p;
+                }
+            }
+
+            reason = StringSlice(start, (StringSlice::size_type)(p - start));
+
+            res = http_parse_eol(p, end);
+            if (res == 0)
+            {
+                res = http_parse_headers(p, end, headers, max_headers, num_headers);
+            }
+
+            return res == 0 ? (int)(p - buffer.data()) : res;
+        }
+    }
+
+    /// Parse an HTTP/1.x request head. Returns the number of bytes in the head (including the final blank line)
+    /// on success, http_parse_incomplete if more data is needed, or http_parse_error. Having more headers than
+    /// the request can hold is an error. When the head arrives in pieces, pass the buffer size from the previous
+    /// incomplete attempt as last_size; the parse is then skipped until the end of the head has arrived.
+    template<StringSlice::size_type MaxHeaders>
+    int parse_http_request(const StringSlice& buffer, HttpRequest<MaxHeaders>& request,
+        StringSlice::size_type last_size = 0) noexcept
+    {
+        return detail::http_parse_request(buffer, request.method, request.path, request.minor_version,
+            request.headers, MaxHeaders, request.num_headers, last_size);
+    }
+
+    /// Parse an HTTP/1.x response head. Return values are the same as parse_http_request.
+    template<StringSlice::size_type MaxHeaders>
+    int parse_http_response(const StringSlice& buffer, HttpResponse<MaxHeaders>& response,
+        StringSlice::size_type last_size = 0) noexcept
+    {
+        return detail::http_parse_response(buffer, response.minor_version, response.status, response.reason,
+            response.headers, MaxHeaders, response.num_headers, last_size);
+    }
+
+    /// Incremental decoder for a chunked transfer-encoding body. Body data is returned as slices of the input,
+    /// so nothing is copied. Chunk extensions and trailers are skipped. This class does not throw exceptions.
+    class HttpChunkedDecoder
+    {
+    public:
+        using size_type = StringSlice::size_type;
+
+        HttpChunkedDecoder() noexcept
+            : m_state(State::Size), m_remaining(0), m_digits(0)
+        {
+        }
+
+        /// Returns true once the last chunk and trailers have been decoded.
+        bool done() const noexcept { return m_state == State::Done; }
+
+        /// Returns true if the input was malformed.
+        bool error() const noexcept { return m_state == State::Error; }
+
+        /// Decode from the start of input. Sets data to the next piece of body data (empty if none was reached)
+        /// and returns the number of input bytes consumed. At most one piece of data is returned per call, so call
+        /// again with the rest of the input. Once done, bytes after the body are not consumed.
+        size_type decode(const StringSlice& input, StringSlice& data) noexcept
+        {
+            data = StringSlice();
+
+            size_type i = 0;
+            while (i < input.size())
+            {
+                char c = input[i];
+
+                switch (m_state)
+                {
+                case State::Size:
+                    if (!add_hex_digit(c))
+                    {
+                        if (m_digits == 0)
+                        {
+                            m_state = State::Error;
+                        }
+                        else if (c == ';' || c == ' ' || c == '\t')
+                        {
+                            m_state = State::SizeExt;
+                        }
+                        else if (c == '\r')
+                        {
+                            m_state = State::SizeLf;
+                        }
+                        else if (c == '\n')
+                        {
+                            end_size_line();
+                        }
+                        else
+                        {
+                            m_state = State::Error;
+                        }
+                    }
+                    break;
+
+                case State::SizeExt:
+                    if (c == '\n')
+                    {
+                        end_size_line();
+                    }
+                    break;
+
+                case State::SizeLf:
+                    if (c == '\n')
+                    {
+                        end_size_line();
+                    }
+                    else
+                    {
+                        m_state = State::Error;
+                    }
+                    break;
+
+                case State::Data:
+                {
+                    size_type available = input.size() - i;
+                    size_type n = available < m_remaining ? available : m_remaining;
+                    data = input.substr(i, n);
+                    m_remaining -= n;
+
+                    if (m_remaining == 0)
+                    {
+                        m_state = State::DataCr;
+                    }
+
+                    return i + n;
+                }
+
+                case State::DataCr:
+                    if (c == '\r')
+                    {
+                        m_state = State::DataLf;
+                    }
+                    else if (c == '\n')
+                    {
+                        m_state = State::Size;
+                    }
+                    else
+                    {
+                        m_state = State::Error;
+                    }
+                    break;
+
+                case State::DataLf:
+                    m_state = c == '\n' ? State::Size : State::Error;
+                    break;
+
+                case State::TrailerStart:
+                    if (c == '\r')
+                    {
+                        m_state = State::TrailerEndLf;
+                    }
+                    else if (c == '\n')
+                    {
+                        m_state = State::Done;
+                    }
+                    else
+                    {
+                        m_state = State::TrailerLine;
+                    }
+                    break;
+
+                case State::TrailerLine:
+                    if (c == '\n')
+                    {
+                        m_state = State::TrailerStart;
+                    }
+                    break;
+
+                case State::TrailerEndLf:
+                    m_state = c == '\n' ? State::Done : State::Error;
+                    break;
+
+                case State::Done:
+                case State::Error:
+                    return i;
+                }
+
+                ++i;
+
+                if (m_state == State::Done || m_state == State::Error)
+                {
+                    break;
+                }
+            }
+
+            return i;
+        }
+
+    private:
+        enum class State : unsigned char
+        {
+            Size,
+            SizeExt,
+            SizeLf,
+            Data,
+            DataCr,
+            DataLf,
+            TrailerStart,
+            TrailerLine,
+            TrailerEndLf,
+            Done,
+            Error,
+        };
+
+        /// Add a hex digit to the chunk size. Returns false if c is not a hex digit. Sets the error state if the
+        /// size overflows.
+        bool add_hex_digit(char c) noexcept
+        {
+            size_type v;
+            if (c >= '0' && c <= '9')
+            {
+                v = (size_type)(c - '0');
+            }
+            else if (c >= 'a' && c <= 'f')
+            {
+                v = (size_type)(c - 'a' + 10);
+            }
+            else if (c >= 'A' && c <= 'F')
+            {
+                v = (size_type)(c - 'A' + 10);
+            }
+            else
+            {
+                return false;
+            }
+
+            if (m_remaining > (StringSlice::npos >> 4))
+            {
+                m_state = State::Error;
+                return true;
+            }
+
+            m_remaining = (m_remaining << 4) | v;
+            ++m_digits;
+            return true;
+        }
+
+        void end_size_line() noexcept
+        {
+            m_state = m_remaining == 0 ? State::TrailerStart : State::Data;
+            m_digits = 0;
+        }
+
+        State m_state;
+        size_type m_remaining;
+        size_type m_digits;
+    };
+}
+
+#endif // _SCOTTZ0R_HTTP_PARSER_INCLUDE_GUARD
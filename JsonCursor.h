@@ -0,0 +1,299 @@
+/// @file
+/// Defines the JsonCursor object.
+#ifndef _SCOTTZ0R_JSON_CURSOR_INCLUDE_GUARD
+#define _SCOTTZ0R_JSON_CURSOR_INCLUDE_GUARD
+
+#include "StringSlice.h"
+#include "SliceBits.h"
+
+namespace scottz0r
+{
+    /// On-demand field extraction from a JSON document. This does not build a DOM or allocate. On construction,
+    /// the document is indexed into a caller provided tape: the positions of every structural character ({}[]:,)
+    /// and every unescaped quote outside of strings. The index is built 64 bytes at a time using bitmasks for
+    /// backslashes, quotes and operators, with a prefix XOR of the quote mask to find string regions. Lookups
+    /// then walk the tape instead of the bytes, skipping over values that are not on the requested path.
+    ///
+    /// The tape needs at most one entry per byte of the document. If the tape is too small, or the document has
+    /// an unterminated string, valid() will return false and all lookups will return an empty slice.
+    ///
+    /// This class does not throw exceptions. The cursor has the same lifetime as the document and tape.
+    class JsonCursor
+    {
+    public:
+        using size_type = StringSlice::size_type;
+
+        /// @see JsonCursor(const StringSlice&, uint32_t*, size_type).
+        template<size_type _Size>
+        JsonCursor(const StringSlice& json, uint32_t(&tape)[_Size]) noexcept
+            : JsonCursor(json, tape, _Size)
+        {
+        }
+
+        /// Construct and index a document using the given tape buffer.
+        JsonCursor(const StringSlice& json, uint32_t* tape, size_type tape_capacity) noexcept
+            : m_json(json), m_tape(tape), m_capacity(tape_capacity), m_count(0), m_valid(false)
+        {
+            m_valid = m_tape != nullptr && build_tape();
+        }
+
+        /// Returns true if the document was indexed.
+        bool valid() const noexcept { return m_valid; }
+
+        /// Returns the number of entries used in the tape.
+        size_type tape_size() const noexcept { return m_count; }
+
+        /// Find a value by a dotted path (ex: "user.id" or "items.0.name"). Numeric path segments index into
+        /// arrays. Returns the raw JSON text of the value without surrounding whitespace: strings include their
+        /// quotes and are not unescaped, and objects and arrays include their brackets. Keys are compared to the
+        /// path without unescaping. Returns an empty slice if the path is not found.
+        StringSlice find(const StringSlice& path) const noexcept
+        {
+            if (!m_valid || m_count == 0)
+            {
+                return StringSlice();
+            }
+
+            size_type value_start = 0;
+            size_type k = 0;
+            size_type seg_start = 0;
+
+            while (seg_start <= path.size())
+            {
+                size_type seg_end = path.find('.', seg_start);
+                if (seg_end == StringSlice::npos)
+                {
+                    seg_end = path.size();
+                }
+
+                StringSlice segment = path.substr(seg_start, seg_end - seg_start);
+
+                if (!find_member(k, segment, k, value_start))
+                {
+                    return StringSlice();
+                }
+
+                seg_start = seg_end + 1;
+            }
+
+            size_type end = value_end(k);
+            if (end == StringSlice::npos)
+            {
+                return StringSlice();
+            }
+
+            return m_json.substr(value_start, end - value_start).strip();
+        }
+
+    private:
+        /// Compute the tape of structural positions. Returns false if the tape is too small or a string is not
+        /// terminated.
+        bool build_tape() noexcept
+        {
+            const uint64_t even_bits = 0x5555555555555555ull;
+            uint64_t next_is_escaped = 0;
+            uint64_t in_string_carry = 0;
+
+            for (size_type start = 0; start < m_json.size(); start += bits::block_size)
+            {
+                size_type remaining = m_json.size() - start;
+                unsigned int len = remaining < bits::block_size ? remaining : bits::block_size;
+                const char* p = m_json.data() + start;
+
+                bits::ByteBlock block(p, len);
+                uint64_t backslash = block.eq('\\');
+                uint64_t quote = block.eq('"');
+                uint64_t op = block.eq('{') | block.eq('}') | block.eq('[') | block.eq(']') | block.eq(':') |
+                    block.eq(',');
+
+                // Find escaped characters: a character is escaped if it follows an odd length run of backslashes.
+                backslash &= ~next_is_escaped;
+                uint64_t follows_escape = (backslash << 1) | next_is_escaped;
+                uint64_t odd_starts = backslash & ~even_bits & ~follows_escape;
+                uint64_t even_seq = odd_starts + backslash;
+                next_is_escaped = even_seq < odd_starts ? 1 : 0;
+                uint64_t escaped = (even_bits ^ (even_seq << 1)) & follows_escape;
+
+                quote &= ~escaped;
+                uint64_t in_string = bits::prefix_xor64(quote) ^ in_string_carry;
+                in_string_carry = (uint64_t)0 - (in_string >> 63);
+
+                // Opening quotes are inside the string mask and closing quotes are not; keep both.
+                uint64_t structural = (op & ~in_string) | quote;
+
+                while (structural != 0)
+                {
+                    if (m_count >= m_capacity)
+                    {
+                        return false;
+                    }
+
+                    m_tape[m_count++] = (uint32_t)(start + bits::ctz64(structural));
+                    structural &= structural - 1;
+                }
+            }
+
+            return in_string_carry == 0;
+        }
+
+        char tape_char(size_type k) const noexcept
+        {
+            return k < m_count ? m_json[m_tape[k]] : 0;
+        }
+
+        /// Look up a member of the object or array whose opening bracket is at tape index k. On success, sets
+        /// value_k to the tape index of the member value and value_start to the byte position where the value
+        /// text begins.
+        bool find_member(size_type k, const StringSlice& segment, size_type& value_k, size_type& value_start)
+            const noexcept
+        {
+            char open = tape_char(k);
+            if (open == '[')
+            {
+                size_type index = 0;
+                if (!parse_index(segment, index))
+                {
+                    return false;
+                }
+
+                value_start = m_tape[k] + 1;
+                ++k;
+                if (tape_char(k) == ']')
+                {
+                    return false;
+                }
+
+                for (size_type i = 0; i < index; ++i)
+                {
+                    k = skip_value(k);
+                    if (tape_char(k) != ',')
+                    {
+                        return false;
+                    }
+
+                    value_start = m_tape[k] + 1;
+                    ++k;
+                }
+
+                value_k = k;
+                return true;
+            }
+
+            if (open != '{')
+            {
+                return false;
+            }
+
+            ++k;
+            while (tape_char(k) == '"')
+            {
+                if (tape_char(k + 1) != '"' || tape_char(k + 2) != ':')
+                {
+                    return false;
+                }
+
+                StringSlice key = m_json.substr(m_tape[k] + 1, m_tape[k + 1] - m_tape[k] - 1);
+                value_start = m_tape[k + 2] + 1;
+                k += 3;
+
+                if (key == segment)
+                {
+                    value_k = k;
+                    return true;
+                }
+
+                k = skip_value(k);
+                if (tape_char(k) != ',')
+                {
+                    return false;
+                }
+
+                ++k;
+            }
+
+            return false;
+        }
+
+        /// Returns the tape index following the value at tape index k. Scalars other than strings have no tape
+        /// entry, so k is returned unchanged for them. Returns npos if a container is not closed.
+        size_type skip_value(size_type k) const noexcept
+        {
+            char c = tape_char(k);
+            if (c == '"')
+            {
+                return k + 2;
+            }
+
+            if (c != '{' && c != '[')
+            {
+                return k;
+            }
+
+            size_type depth = 0;
+            for (; k < m_count; ++k)
+            {
+                c = m_json[m_tape[k]];
+                if (c == '{' || c == '[')
+                {
+                    ++depth;
+                }
+                else if (c == '}' || c == ']')
+                {
+                    if (--depth == 0)
+                    {
+                        return k + 1;
+                    }
+                }
+                else if (c == '"')
+                {
+                    // Skip the closing quote so a quote is never mistaken for a bracket.
+                    ++k;
+                }
+            }
+
+            return StringSlice::npos;
+        }
+
+        /// Returns the byte position just past the value at tape index k, or npos if the document is truncated.
+        size_type value_end(size_type k) const noexcept
+        {
+            size_type next = skip_value(k);
+            if (next != k)
+            {
+                return next != StringSlice::npos && next <= m_count ? m_tape[next - 1] + 1 : StringSlice::npos;
+            }
+
+            // Scalar values end at the next structural character, or the end of the document.
+            return k < m_count ? m_tape[k] : m_json.size();
+        }
+
+        static bool parse_index(const StringSlice& segment, size_type& index) noexcept
+        {
+            if (segment.empty())
+            {
+                return false;
+            }
+
+            index = 0;
+            for (size_type i = 0; i < segment.size(); ++i)
+            {
+                if (segment[i] < '0' || segment[i] > '9')
+                {
+                    return false;
+                }
+
+                index = index * 10 + (size_type)(segment[i] - '0');
+            }
+
+            return true;
+        }
+
+        StringSlice m_json;
+        uint32_t* m_tape;
+        size_type m_capacity;
+        size_type m_count;
+        bool m_valid;
+    };
+}
+
+#endif // _SCOTTZ0R_JSON_CURSOR_INCLUDE_GUARD
@@ -0,0 +1,167 @@
+/// @file
+/// Defines the LineIndex object.
+#ifndef _SCOTTZ0R_LINE_INDEX_INCLUDE_GUARD
+#define _SCOTTZ0R_LINE_INDEX_INCLUDE_GUARD
+
+#include "ParallelScan.h"
+
+namespace scottz0r
+{
+    /// Index of line start offsets for O(1) access to any line of a large buffer. Offsets are stored compactly:
+    /// one 64-bit base offset per block of 64 lines, and one 32-bit delta from that base per line, which is
+    /// about 4.1 bytes per line. Storage is provided by the caller; use deltas_needed and bases_needed with the
+    /// newline count (ex: from parallel_count) to size it. A single block of 64 lines must span less than 4 GiB.
+    /// SizeT is the size type of the indexed slice: LineIndex indexes a StringSlice, and LineIndex64 indexes a
+    /// StringSlice64, so buffers over 4 GiB (ex: a memory mapped log with billions of lines) can be indexed.
+    ///
+    /// The index is built in parallel: each chunk counts its newlines, a prefix sum gives each chunk the number
+    /// of its first line, and then each chunk writes its own entries. Lines in a block that starts in an earlier
+    /// chunk are fixed up afterwards, which touches at most 63 entries per chunk.
+    ///
+    /// This class does not throw exceptions. The index has the same lifetime as the slice and storage.
+    template<typename SizeT>
+    class BasicLineIndex
+    {
+    public:
+        using slice_type = BasicStringSlice<char, SizeT>;
+        using size_type = SizeT;
+
+        /// Number of lines per base offset.
+        static constexpr size_type block_lines = 64;
+
+        /// Number of uint32_t deltas needed for a slice with the given number of newlines.
+        static size_type deltas_needed(size_type newlines) noexcept { return newlines + 1; }
+
+        /// Number of uint64_t bases needed for a slice with the given number of newlines.
+        static size_type bases_needed(size_type newlines) noexcept { return newlines / block_lines + 1; }
+
+        /// Construct an empty index.
+        BasicLineIndex() noexcept
+            : m_deltas(nullptr), m_bases(nullptr), m_entries(0), m_lines(0)
+        {
+        }
+
+        /// Build the index for a slice using the given executor (see SliceExecutor.h). Returns false if the
+        /// storage is too small, in which case the index is left empty.
+        template<typename Executor>
+        bool build(const slice_type& slice, uint32_t* deltas, size_type delta_capacity, uint64_t* bases,
+            size_type base_capacity, Executor& executor) noexcept
+        {
+            *this = BasicLineIndex();
+
+            detail::ParallelChunks chunks(slice, executor);
+            size_type first_newline[detail::parallel_max_tasks + 1];
+
+            executor.run(chunks.count(), [&](unsigned int i) {
+                first_newline[i + 1] = slice.substr((size_type)chunks.begin(i),
+                    (size_type)(chunks.end(i) - chunks.begin(i))).count('\n');
+            });
+
+            first_newline[0] = 0;
+            for (unsigned int i = 0; i < chunks.count(); ++i)
+            {
+                first_newline[i + 1] += first_newline[i];
+            }
+
+            size_type newlines = first_newline[chunks.count()];
+            if (!deltas || !bases || delta_capacity < deltas_needed(newlines) || base_capacity < bases_needed(newlines))
+            {
+                return false;
+            }
+
+            bases[0] = 0;
+            deltas[0] = 0;
+
+            executor.run(chunks.count(), [&](unsigned int i) {
+                write_chunk(slice, (size_type)chunks.begin(i), (size_type)chunks.end(i), first_newline[i], deltas,
+                    bases);
+            });
+
+            // Lines at the start of a chunk whose block base is in an earlier chunk were written relative to the
+            // chunk start. Now that every base is known, make them relative to their block base.
+            for (unsigned int i = 1; i < chunks.count(); ++i)
+            {
+                size_type first_line = first_newline[i] + 1;
+                size_type end_line = first_newline[i + 1] + 1;
+                size_type block = first_line / block_lines;
+                size_type block_end = (block + 1) * block_lines;
+
+                for (size_type line = first_line; line < end_line && line < block_end && line % block_lines != 0; ++line)
+                {
+                    deltas[line] = (uint32_t)(chunks.begin(i) + deltas[line] - bases[block]);
+                }
+            }
+
+            m_slice = slice;
+            m_deltas = deltas;
+            m_bases = bases;
+            m_entries = newlines + 1;
+            m_lines = newlines + (slice.empty() || slice[slice.size() - 1] == '\n' ? 0 : 1);
+            return true;
+        }
+
+        /// Returns the number of lines. A final line without a newline is counted.
+        size_type size() const noexcept { return m_lines; }
+
+        /// Get a line by number, starting at 0. Like get_line, the newline is included. Returns an empty slice if
+        /// n is out of range.
+        slice_type line(size_type n) const noexcept
+        {
+            if (n >= m_lines)
+            {
+                return slice_type();
+            }
+
+            size_type start = offset(n);
+            size_type end = n + 1 < m_entries ? offset(n + 1) : m_slice.size();
+            return m_slice.substr(start, end - start);
+        }
+
+        /// Returns the offset where line n starts, without range checking. n must be less than size(), or equal to
+        /// it if the slice ends with a newline, which gives the slice size.
+        size_type offset(size_type n) const noexcept
+        {
+            return (size_type)(m_bases[n / block_lines] + m_deltas[n]);
+        }
+
+    private:
+        /// Write the entries for the lines that start after each newline in [begin, end). first_newline is the
+        /// global number of the first newline in the chunk.
+        static void write_chunk(const slice_type& slice, size_type begin, size_type end, size_type first_newline,
+            uint32_t* deltas, uint64_t* bases) noexcept
+        {
+            slice_type chunk = slice.substr(begin, end - begin);
+            size_type line = first_newline + 1;
+
+            // Lines before the first block start in this chunk are written relative to the chunk start.
+            uint64_t base = begin;
+
+            for (size_type pos = chunk.find('\n'); pos != slice_type::npos; pos = chunk.find('\n', pos + 1), ++line)
+            {
+                uint64_t start = (uint64_t)begin + pos + 1;
+
+                if (line % block_lines == 0)
+                {
+                    base = start;
+                    bases[line / block_lines] = start;
+                }
+
+                deltas[line] = (uint32_t)(start - base);
+            }
+        }
+
+        slice_type m_slice;
+        const uint32_t* m_deltas;
+        const uint64_t* m_bases;
+        size_type m_entries;
+        size_type m_lines;
+    };
+
+    /// Line index of a StringSlice.
+    using LineIndex = BasicLineIndex<StringSlice::size_type>;
+
+    /// Line index of a StringSlice64, for buffers over 4 GiB.
+    using LineIndex64 = BasicLineIndex<uint64_t>;
+}
+
+#endif // _SCOTTZ0R_LINE_INDEX_INCLUDE_GUARD
@@ -0,0 +1,175 @@
+/// @file
+/// Defines the LiteralNeedle object and search functions specialized for needles known at compile time.
+#ifndef _SCOTTZ0R_LITERAL_NEEDLE_INCLUDE_GUARD
+#define _SCOTTZ0R_LITERAL_NEEDLE_INCLUDE_GUARD
+
+#include "StringSlice.h"
+
+namespace scottz0r
+{
+    namespace detail
+    {
+        /// Frequency of an ASCII letter, or 0 if c is not one. Letters are checked from position i of the
+        /// English frequency order; lower case letters are more common than upper case ones.
+        constexpr unsigned int letter_frequency(unsigned char c, unsigned int i) noexcept
+        {
+            return i == 26 ? 0 :
+                c == (unsigned char)"etaoinshrdlcumwfgypbvkjxqz"[i] ? 200 - 4 * i :
+                c == (unsigned char)("etaoinshrdlcumwfgypbvkjxqz"[i] - 'a' + 'A') ? 90 - 2 * i :
+                letter_frequency(c, i + 1);
+        }
+
+        /// Rough relative frequency of a byte in text such as logs, source code and JSON. Higher is more common.
+        /// Only the ordering matters; it is used to pick the rarest bytes of a needle as search anchors. Written
+        /// as a single return so it is a C++11 constexpr function.
+        constexpr unsigned int byte_frequency(unsigned char c) noexcept
+        {
+            return letter_frequency(c, 0) != 0 ? letter_frequency(c, 0) :
+                c == ' ' ? 255 :
+                c >= '0' && c <= '9' ? (c <= '2' ? 110 : 95) :
+                c == '\n' || c == '"' || c == ',' || c == '.' || c == ':' || c == '-' || c == '_' || c == '/' ||
+                    c == '(' || c == ')' || c == '=' || c == '\'' ? 120 :
+                c == '\t' || c == '\r' ? 60 :
+                c > ' ' && c < 0x7F ? 40 :
+                // UTF-8 continuation and lead bytes, then control characters.
+                c >= 0x80 ? 20 : 5;
+        }
+
+        /// Index of the rarest byte of str in [i, size), skipping position skip, or best if none is rarer than
+        /// str[best]. Ties keep the earlier position.
+        constexpr StringSlice::size_type rarest_byte(const char* str, StringSlice::size_type i,
+            StringSlice::size_type size, StringSlice::size_type best, StringSlice::size_type skip) noexcept
+        {
+            return i >= size ? best : rarest_byte(str, i + 1, size,
+                i != skip && byte_frequency((unsigned char)str[i]) < byte_frequency((unsigned char)str[best]) ? i : best,
+                skip);
+        }
+
+        /// Compile time list of array indices, used to copy a needle's characters in a C++11 constexpr
+        /// constructor.
+        template<StringSlice::size_type... I>
+        struct NeedleIndices
+        {
+        };
+
+        template<StringSlice::size_type N, StringSlice::size_type... I>
+        struct MakeNeedleIndices : MakeNeedleIndices<N - 1, N - 1, I...>
+        {
+        };
+
+        template<StringSlice::size_type... I>
+        struct MakeNeedleIndices<0, I...>
+        {
+            using type = NeedleIndices<I...>;
+        };
+    }
+
+    /// A needle whose contents are known at compile time. Construct it with make_needle (or as a template argument
+    /// in C++20), which picks the two rarest bytes of the needle as anchors while compiling. Searching then skips
+    /// to occurrences of the rarest byte with the word-at-a-time StringSlice::find, checks the second anchor, and
+    /// only then compares the whole needle with a fixed size compare the compiler can unroll.
+    ///
+    /// Size is the size of the character array, including the null terminator. The members are public so that
+    /// the type can be used as a C++20 template argument; treat them as read only.
+    template<StringSlice::size_type Size>
+    struct LiteralNeedle
+    {
+        static_assert(Size != 0, "Buffer size cannot be 0");
+
+        /// Number of characters in the needle.
+        static constexpr StringSlice::size_type size = Size - 1;
+
+        /// Build a needle from a null terminated character array.
+        constexpr LiteralNeedle(const char(&str)[Size]) noexcept
+            : LiteralNeedle(str, typename detail::MakeNeedleIndices<Size>::type())
+        {
+        }
+
+        /// Returns the needle as a slice.
+        constexpr StringSlice slice() const noexcept { return StringSlice(chars, size); }
+
+        char chars[Size];
+        StringSlice::size_type anchor;
+        StringSlice::size_type second_anchor;
+
+    private:
+        /// Copies the characters and picks the anchors in the initializer list. The anchor is the rarest byte,
+        /// and the second anchor the rarest of the others.
+        template<StringSlice::size_type... I>
+        constexpr LiteralNeedle(const char(&str)[Size], detail::NeedleIndices<I...>) noexcept
+            : chars{ str[I]... }, anchor(detail::rarest_byte(str, 1, size, 0, StringSlice::npos)),
+            second_anchor(detail::rarest_byte(str, 0, size, anchor == 0 && size > 1 ? 1 : 0, anchor))
+        {
+        }
+    };
+
+    /// Build a LiteralNeedle from a string literal. Declare the result constexpr so the anchors are chosen at
+    /// compile time (ex: `constexpr auto needle = make_needle("ERROR");`).
+    template<StringSlice::size_type Size>
+    constexpr LiteralNeedle<Size> make_needle(const char(&str)[Size]) noexcept
+    {
+        return LiteralNeedle<Size>(str);
+    }
+
+    /// Find a compile time needle in the haystack. Returns the index of the first match at or after start, or
+    /// StringSlice::npos. An empty needle matches at start.
+    template<StringSlice::size_type Size>
+    StringSlice::size_type find(const StringSlice& haystack, const LiteralNeedle<Size>& needle,
+        StringSlice::size_type start = 0) noexcept
+    {
+        constexpr StringSlice::size_type size = LiteralNeedle<Size>::size;
+        if (size == 0)
+        {
+            return start <= haystack.size() ? start : StringSlice::npos;
+        }
+
+        if (haystack.size() < size || start > haystack.size() - size)
+        {
+            return StringSlice::npos;
+        }
+
+        // Only look for the anchor where the whole needle would fit.
+        const StringSlice::size_type anchor = needle.anchor;
+        const char anchor_char = needle.chars[anchor];
+        const StringSlice::size_type second_anchor = needle.second_anchor;
+        const char second_char = needle.chars[needle.second_anchor];
+        StringSlice window(haystack.data(), haystack.size() - size + anchor + 1);
+
+        for (StringSlice::size_type i = window.find(anchor_char, start + anchor); i != StringSlice::npos;
+            i = window.find(anchor_char, i + 1))
+        {
+            const char* candidate = haystack.data() + i - anchor;
+            if (candidate[second_anchor] == second_char && memcmp(candidate, needle.chars, size) == 0)
+            {
+                return i - anchor;
+            }
+        }
+
+        return StringSlice::npos;
+    }
+
+    /// Returns true if the haystack contains the compile time needle.
+    template<StringSlice::size_type Size>
+    bool contains(const StringSlice& haystack, const LiteralNeedle<Size>& needle) noexcept
+    {
+        return find(haystack, needle) != StringSlice::npos;
+    }
+
+#if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L
+    /// Find a needle given as a template argument (ex: `find<"ERROR">(line)`). Same as find with make_needle.
+    template<LiteralNeedle Needle>
+    StringSlice::size_type find(const StringSlice& haystack, StringSlice::size_type start = 0) noexcept
+    {
+        return find(haystack, Needle, start);
+    }
+
+    /// Returns true if the haystack contains the needle given as a template argument (ex: `contains<"ERROR">(line)`).
+    template<LiteralNeedle Needle>
+    bool contains(const StringSlice& haystack) noexcept
+    {
+        return find(haystack, Needle) != StringSlice::npos;
+    }
+#endif
+}
+
+#endif // _SCOTTZ0R_LITERAL_NEEDLE_INCLUDE_GUARD
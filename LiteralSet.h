@@ -0,0 +1,297 @@
+/// @file
+/// Defines the LiteralSet object.
+#ifndef _SCOTTZ0R_LITERAL_SET_INCLUDE_GUARD
+#define _SCOTTZ0R_LITERAL_SET_INCLUDE_GUARD
+
+#include "StringSlice.h"
+
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#define SCOTTZ0R_LITERAL_SET_HAS_SSSE3 1
+#endif
+
+namespace scottz0r
+{
+    /// Matcher for a small set of literals (up to 64), such as "ERROR", "WARN" and "FATAL". This uses the
+    /// "Teddy" approach: the patterns are split into 8 buckets, and for each of the first 1 to 3 pattern bytes a
+    /// table maps a haystack byte to the set of buckets that have a pattern with that byte at that position. ANDing
+    /// the lookups for consecutive bytes gives the buckets that might match at a position, and only those
+    /// patterns are compared. With SSSE3 the lookups are split into low and high nibble tables so that 16
+    /// positions are checked per step with byte shuffles; otherwise full 256 entry tables are used a byte at a
+    /// time.
+    ///
+    /// The patterns are not copied; they must outlive the set. The set itself is about 2.5 KiB and does not
+    /// allocate. This class does not throw exceptions.
+    class LiteralSet
+    {
+    public:
+        using size_type = StringSlice::size_type;
+
+        /// Maximum number of patterns.
+        static constexpr size_type max_patterns = 64;
+
+        /// Construct an empty set that matches nothing.
+        LiteralSet() noexcept
+            : m_count(0), m_fingerprint(0)
+        {
+        }
+
+        /// Set the patterns. Returns false if there are no patterns, more than max_patterns, or an empty pattern,
+        /// in which case the set is left empty.
+        bool build(const StringSlice* patterns, size_type count) noexcept
+        {
+            *this = LiteralSet();
+
+            if (count == 0 || count > max_patterns)
+            {
+                return false;
+            }
+
+            size_type min_size = patterns[0].size();
+            for (size_type i = 0; i < count; ++i)
+            {
+                if (patterns[i].empty())
+                {
+                    return false;
+                }
+
+                m_patterns[i] = patterns[i];
+                min_size = patterns[i].size() < min_size ? patterns[i].size() : min_size;
+            }
+
+            m_count = count;
+            m_fingerprint = min_size < max_fingerprint ? min_size : max_fingerprint;
+
+            assign_buckets();
+            build_tables();
+            return true;
+        }
+
+        /// @see build(const StringSlice*, size_type).
+        template<size_type _Size>
+        bool build(const StringSlice(&patterns)[_Size]) noexcept
+        {
+            return build(patterns, _Size);
+        }
+
+        /// Find the first match at or after start. Returns the match position and sets pattern to the index of the
+        /// matching pattern (the lowest index if several match at the same position). Returns StringSlice::npos if
+        /// there is no match.
+        size_type find(const StringSlice& haystack, size_type& pattern, size_type start = 0) const noexcept
+        {
+            size_type found = StringSlice::npos;
+            scan(haystack, start, [&](size_type p, size_type pos) {
+                if (found == StringSlice::npos || p < pattern)
+                {
+                    found = pos;
+                    pattern = p;
+                }
+
+                // Keep going only to check the other patterns at this position.
+                return false;
+            });
+
+            return found;
+        }
+
+        /// Call fn(size_type pattern, size_type position) for every match, including overlapping ones, in order
+        /// of position.
+        template<typename Fn>
+        void find_all(const StringSlice& haystack, Fn&& fn) const noexcept
+        {
+            scan(haystack, 0, [&](size_type p, size_type pos) {
+                fn(p, pos);
+                return true;
+            });
+        }
+
+    private:
+        static constexpr size_type max_fingerprint = 3;
+        static constexpr unsigned int bucket_count = 8;
+
+        /// Sort the patterns by their fingerprint bytes and split the sorted order into 8 even runs, so patterns
+        /// with similar prefixes share a bucket and a candidate hit tends to point at few buckets.
+        void assign_buckets() noexcept
+        {
+            uint8_t order[max_patterns];
+            for (size_type i = 0; i < m_count; ++i)
+            {
+                order[i] = (uint8_t)i;
+            }
+
+            for (size_type i = 1; i < m_count; ++i)
+            {
+                uint8_t v = order[i];
+                size_type j = i;
+                while (j > 0 && fingerprint(v) < fingerprint(order[j - 1]))
+                {
+                    order[j] = order[j - 1];
+                    --j;
+                }
+
+                order[j] = v;
+            }
+
+            for (unsigned int b = 0; b < bucket_count; ++b)
+            {
+                m_bucket_size[b] = 0;
+            }
+
+            // Fill buckets in pattern index order so matches at one position are checked lowest index first.
+            uint8_t bucket_of[max_patterns];
+            for (size_type rank = 0; rank < m_count; ++rank)
+            {
+                bucket_of[order[rank]] = (uint8_t)(rank * bucket_count / m_count);
+            }
+
+            for (size_type i = 0; i < m_count; ++i)
+            {
+                uint8_t b = bucket_of[i];
+                m_buckets[b][m_bucket_size[b]++] = (uint8_t)i;
+            }
+        }
+
+        StringSlice fingerprint(size_type pattern) const noexcept
+        {
+            return m_patterns[pattern].substr(0, m_fingerprint);
+        }
+
+        void build_tables() noexcept
+        {
+            for (size_type k = 0; k < max_fingerprint; ++k)
+            {
+                for (unsigned int c = 0; c < 256; ++c)
+                {
+                    m_byte_table[k][c] = k < m_fingerprint ? 0 : 0xFF;
+                }
+
+                for (unsigned int n = 0; n < 16; ++n)
+                {
+                    m_low_table[k][n] = k < m_fingerprint ? 0 : 0xFF;
+                    m_high_table[k][n] = k < m_fingerprint ? 0 : 0xFF;
+                }
+            }
+
+            for (unsigned int b = 0; b < bucket_count; ++b)
+            {
+                for (unsigned int j = 0; j < m_bucket_size[b]; ++j)
+                {
+                    const StringSlice& p = m_patterns[m_buckets[b][j]];
+                    for (size_type k = 0; k < m_fingerprint; ++k)
+                    {
+                        uint8_t c = (uint8_t)p[k];
+                        m_byte_table[k][c] |= (uint8_t)(1 << b);
+                        m_low_table[k][c & 0x0F] |= (uint8_t)(1 << b);
+                        m_high_table[k][c >> 4] |= (uint8_t)(1 << b);
+                    }
+                }
+            }
+        }
+
+        /// Compare the patterns in the candidate buckets at pos. Calls fn(pattern, pos) for each match; stops and
+        /// returns false if fn returns false.
+        template<typename Fn>
+        bool verify(const StringSlice& haystack, size_type pos, uint8_t buckets, Fn& fn) const noexcept
+        {
+            bool keep_going = true;
+            while (buckets != 0)
+            {
+                unsigned int b = bits::ctz64(buckets);
+                buckets &= (uint8_t)(buckets - 1);
+
+                for (unsigned int j = 0; j < m_bucket_size[b]; ++j)
+                {
+                    size_type p = m_buckets[b][j];
+                    const StringSlice& pattern = m_patterns[p];
+                    if (haystack.size() - pos >= pattern.size() && StringSlice(haystack.data() + pos, pattern.size()) == pattern)
+                    {
+                        keep_going = fn(p, pos) && keep_going;
+                    }
+                }
+            }
+
+            return keep_going;
+        }
+
+        /// Run fn(pattern, pos) for matches in position order. Once fn returns false, the scan stops after the
+        /// current position.
+        template<typename Fn>
+        void scan(const StringSlice& haystack, size_type start, Fn&& fn) const noexcept
+        {
+            if (m_count == 0 || haystack.size() < m_fingerprint)
+            {
+                return;
+            }
+
+            const uint8_t* p = (const uint8_t*)haystack.data();
+            size_type last = haystack.size() - m_fingerprint;
+            size_type i = start;
+
+#if defined(SCOTTZ0R_LITERAL_SET_HAS_SSSE3)
+            const __m128i nibble = _mm_set1_epi8(0x0F);
+            __m128i low[max_fingerprint];
+            __m128i high[max_fingerprint];
+            for (size_type k = 0; k < max_fingerprint; ++k)
+            {
+                low[k] = _mm_loadu_si128((const __m128i*)m_low_table[k]);
+                high[k] = _mm_loadu_si128((const __m128i*)m_high_table[k]);
+            }
+
+            // Each block checks the 16 positions i to i + 15, which reads up to byte i + 15 + max_fingerprint - 1.
+            while (haystack.size() >= 16 + max_fingerprint - 1 && i <= haystack.size() - (16 + max_fingerprint - 1))
+            {
+                __m128i result = _mm_set1_epi8((char)0xFF);
+                for (size_type k = 0; k < m_fingerprint; ++k)
+                {
+                    __m128i input = _mm_loadu_si128((const __m128i*)(p + i + k));
+                    __m128i lo = _mm_shuffle_epi8(low[k], _mm_and_si128(input, nibble));
+                    __m128i hi = _mm_shuffle_epi8(high[k], _mm_and_si128(_mm_srli_epi16(input, 4), nibble));
+                    result = _mm_and_si128(result, _mm_and_si128(lo, hi));
+                }
+
+                unsigned int hits = ~(unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(result, _mm_setzero_si128())) & 0xFFFF;
+                if (hits != 0)
+                {
+                    uint8_t buckets[16];
+                    _mm_storeu_si128((__m128i*)buckets, result);
+
+                    while (hits != 0)
+                    {
+                        unsigned int j = bits::ctz64(hits);
+                        hits &= hits - 1;
+
+                        if (!verify(haystack, i + j, buckets[j], fn))
+                        {
+                            return;
+                        }
+                    }
+                }
+
+                i += 16;
+            }
+#endif
+
+            for (; i <= last; ++i)
+            {
+                uint8_t buckets = m_byte_table[0][p[i]] & m_byte_table[1][p[i + (m_fingerprint > 1)]] &
+                    m_byte_table[2][p[i + (m_fingerprint > 2 ? 2 : 0)]];
+
+                if (buckets != 0 && !verify(haystack, i, buckets, fn))
+                {
+                    return;
+                }
+            }
+        }
+
+        StringSlice m_patterns[max_patterns];
+        uint8_t m_buckets[bucket_count][max_patterns];
+        uint8_t m_bucket_size[bucket_count];
+        uint8_t m_byte_table[max_fingerprint][256];
+        uint8_t m_low_table[max_fingerprint][16];
+        uint8_t m_high_table[max_fingerprint][16];
+        size_type m_count;
+        size_type m_fingerprint;
+    };
+}
+
+#endif // _SCOTTZ0R_LITERAL_SET_INCLUDE_GUARD
@@ -0,0 +1,119 @@
+/// @file
+/// Parallel line processing with newline aligned chunks.
+#ifndef _SCOTTZ0R_PARALLEL_LINES_INCLUDE_GUARD
+#define _SCOTTZ0R_PARALLEL_LINES_INCLUDE_GUARD
+
+#include "ParallelScan.h"
+
+namespace scottz0r
+{
+    namespace detail
+    {
+        /// Splits a slice into chunks of whole lines. Each cut point from ParallelChunks is moved forward to the
+        /// next line start, so every line belongs to exactly one chunk. Cut points inside the same long line move
+        /// to the same place, which leaves some chunks empty.
+        template<typename SizeT>
+        class LineChunks
+        {
+        public:
+            using slice_type = BasicStringSlice<char, SizeT>;
+            using size_type = SizeT;
+
+            template<typename Executor>
+            LineChunks(const slice_type& slice, const Executor& executor) noexcept
+                : m_slice(slice), m_chunks(slice, executor)
+            {
+            }
+
+            unsigned int count() const noexcept { return m_chunks.count(); }
+
+            /// Returns the lines in chunk i.
+            slice_type chunk(unsigned int i) const noexcept
+            {
+                // Cut points are never past the slice size, so they fit in size_type.
+                size_type begin = line_start((size_type)m_chunks.begin(i));
+                size_type end = line_start((size_type)m_chunks.end(i));
+                return m_slice.substr(begin, end - begin);
+            }
+
+        private:
+            /// Returns the first line start at or after pos.
+            size_type line_start(size_type pos) const noexcept
+            {
+                if (pos == 0 || pos >= m_slice.size() || m_slice[pos - 1] == '\n')
+                {
+                    return pos;
+                }
+
+                size_type newline = m_slice.find('\n', pos);
+                return newline == slice_type::npos ? m_slice.size() : newline + 1;
+            }
+
+            slice_type m_slice;
+            ParallelChunks m_chunks;
+        };
+
+        /// Call fn(line) for each line of a chunk, in order. Lines include their newline, like get_line.
+        template<typename SizeT, typename Fn>
+        inline void for_each_line(const BasicStringSlice<char, SizeT>& chunk, Fn&& fn)
+        {
+            using Slice = BasicStringSlice<char, SizeT>;
+
+            SizeT start = 0;
+            while (start < chunk.size())
+            {
+                SizeT newline = chunk.find('\n', start);
+                SizeT end = newline == Slice::npos ? chunk.size() : newline + 1;
+                fn(chunk.substr(start, end - start));
+                start = end;
+            }
+        }
+    }
+
+    /// Call fn(const StringSlice& line) for every line of the slice using the given executor (see
+    /// SliceExecutor.h). Lines include their newline, like get_line, and a final line without a newline is
+    /// included. The slice is split at line starts near equal size cut points, so no line is split or seen twice.
+    /// Lines within a chunk are visited in order, but chunks run concurrently, so fn must be safe to call from
+    /// several threads. If fn throws, the first exception is rethrown once every chunk has finished. Works on
+    /// StringSlice and StringSlice64, and lines have the same slice type as the input.
+    template<typename SizeT, typename Executor, typename Fn>
+    void for_each_line_parallel(const BasicStringSlice<char, SizeT>& slice, Fn&& fn, Executor& executor)
+    {
+        detail::LineChunks<SizeT> chunks(slice, executor);
+
+        run_rethrow(executor, chunks.count(), [&](unsigned int i) {
+            detail::for_each_line(chunks.chunk(i), fn);
+        });
+    }
+
+    /// Process every line with a private accumulator per chunk, then combine the accumulators. Each chunk starts
+    /// with a copy of init and calls fn(Acc& acc, const StringSlice& line) for its lines, so fn does not need any
+    /// locking. The chunk accumulators are then combined in slice order with reduce(Acc& total, const Acc& acc),
+    /// starting from another copy of init. init should be an identity value, such as 0 for a sum or an empty
+    /// container. The accumulators are allocated on the calling thread, so this can throw std::bad_alloc, and an
+    /// exception from fn is rethrown once every chunk has finished. For a StringSlice64, lines are StringSlice64.
+    template<typename SizeT, typename Acc, typename Executor, typename Fn, typename Reduce>
+    Acc reduce_lines_parallel(const BasicStringSlice<char, SizeT>& slice, const Acc& init, Fn&& fn,
+        Reduce&& reduce, Executor& executor)
+    {
+        detail::LineChunks<SizeT> chunks(slice, executor);
+        std::vector<Acc> accumulators(chunks.count(), init);
+
+        run_rethrow(executor, chunks.count(), [&](unsigned int i) {
+            Acc& acc = accumulators[i];
+            detail::for_each_line(chunks.chunk(i), [&](const BasicStringSlice<char, SizeT>& line) {
+                fn(acc, line);
+            });
+        });
+
+        Acc total = init;
+        for (const Acc& acc : accumulators)
+        {
+            reduce(total, acc);
+        }
+
+        return total;
+    }
+}
+
+#endif // _SCOTTZ0R_PARALLEL_LINES_INCLUDE_GUARD
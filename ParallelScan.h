@@ -0,0 +1,198 @@
+/// @file
+/// Multi-threaded find and count over large slices.
+#ifndef _SCOTTZ0R_PARALLEL_SCAN_INCLUDE_GUARD
+#define _SCOTTZ0R_PARALLEL_SCAN_INCLUDE_GUARD
+
+#include "StringSlice.h"
+#include "SliceExecutor.h"
+
+namespace scottz0r
+{
+    namespace detail
+    {
+        /// Upper bound on the number of chunks a scan is split into. Per-chunk results live on the stack.
+        static constexpr unsigned int parallel_max_tasks = 256;
+
+        /// Chunks are not made smaller than this, so small slices are not split more than is useful.
+        static constexpr StringSlice::size_type parallel_min_chunk = 64 * 1024;
+
+        /// Splits a slice into contiguous chunks. There are several chunks per thread so that threads that finish
+        /// early can take chunks that would otherwise wait on a slow thread. Positions are 64-bit so slices of any
+        /// size type can be split.
+        class ParallelChunks
+        {
+        public:
+            using size_type = uint64_t;
+
+            template<typename SizeT, typename Executor>
+            ParallelChunks(const BasicStringSlice<char, SizeT>& slice, const Executor& executor) noexcept
+                : m_size(slice.size()), m_count(1)
+            {
+                uint64_t by_size = m_size / parallel_min_chunk;
+                uint64_t wanted = (uint64_t)executor.concurrency() * 4;
+                uint64_t count = by_size < wanted ? by_size : wanted;
+                count = count < parallel_max_tasks ? count : parallel_max_tasks;
+                m_count = count > 1 ? (unsigned int)count : 1;
+            }
+
+            unsigned int count() const noexcept { return m_count; }
+
+            size_type begin(unsigned int i) const noexcept
+            {
+                // Split the product so sizes near 2^64 do not overflow.
+                return m_size / m_count * i + m_size % m_count * i / m_count;
+            }
+
+            size_type end(unsigned int i) const noexcept
+            {
+                return begin(i + 1);
+            }
+
+        private:
+            size_type m_size;
+            unsigned int m_count;
+        };
+
+        /// The slice type scanned by the parallel functions. The needle parameters use it in a non-deduced
+        /// context, so the haystack alone picks the size type and needles can be string literals.
+        template<typename SizeT>
+        struct ScanSlice
+        {
+            using type = BasicStringSlice<char, SizeT>;
+        };
+
+        /// Call fn(pos) for each match of needle that starts in [begin, end). Returns the number of matches.
+        template<typename SizeT, typename Fn>
+        inline SizeT parallel_chunk_matches(const BasicStringSlice<char, SizeT>& slice,
+            const BasicStringSlice<char, SizeT>& needle, SizeT begin, SizeT end, Fn&& fn) noexcept
+        {
+            using Slice = BasicStringSlice<char, SizeT>;
+
+            // Extend the chunk so matches that start inside it but cross its end are found.
+            Slice region = slice.substr(begin, end - begin + needle.size() - 1);
+            SizeT n = 0;
+
+            for (SizeT pos = region.find(needle); pos != Slice::npos && pos < end - begin;
+                pos = region.find(needle, pos + 1))
+            {
+                fn(begin + pos);
+                ++n;
+            }
+
+            return n;
+        }
+    }
+
+    /// Count the occurrences of a character using the given executor (see SliceExecutor.h). Works on StringSlice
+    /// and, for buffers over 4 GiB such as memory mapped files, StringSlice64.
+    template<typename SizeT, typename Executor>
+    SizeT parallel_count(const BasicStringSlice<char, SizeT>& slice, char c, Executor& executor) noexcept
+    {
+        detail::ParallelChunks chunks(slice, executor);
+        std::atomic<SizeT> total(0);
+
+        executor.run(chunks.count(), [&](unsigned int i) {
+            BasicStringSlice<char, SizeT> chunk = slice.substr((SizeT)chunks.begin(i),
+                (SizeT)(chunks.end(i) - chunks.begin(i)));
+            total.fetch_add(chunk.count(c), std::memory_order_relaxed);
+        });
+
+        return total.load();
+    }
+
+    /// Find the first occurrence of needle using the given executor. Returns the same result as slice.find(needle).
+    /// Chunks that start after a match found by another thread are skipped.
+    template<typename SizeT, typename Executor>
+    SizeT parallel_find(const BasicStringSlice<char, SizeT>& slice,
+        const typename detail::ScanSlice<SizeT>::type& needle, Executor& executor) noexcept
+    {
+        using Slice = BasicStringSlice<char, SizeT>;
+        if (needle.empty())
+        {
+            return 0;
+        }
+
+        detail::ParallelChunks chunks(slice, executor);
+        std::atomic<SizeT> best(Slice::npos);
+
+        executor.run(chunks.count(), [&](unsigned int i) {
+            SizeT begin = (SizeT)chunks.begin(i);
+            SizeT end = (SizeT)chunks.end(i);
+            if (begin >= best.load(std::memory_order_relaxed))
+            {
+                return;
+            }
+
+            Slice region = slice.substr(begin, end - begin + needle.size() - 1);
+            SizeT pos = region.find(needle);
+            if (pos == Slice::npos || pos >= end - begin)
+            {
+                return;
+            }
+
+            pos += begin;
+            SizeT current = best.load();
+            while (pos < current && !best.compare_exchange_weak(current, pos))
+            {
+            }
+        });
+
+        return best.load();
+    }
+
+    /// @see parallel_find(const BasicStringSlice<char, SizeT>&, const BasicStringSlice<char, SizeT>&, Executor&).
+    template<typename SizeT, typename Executor>
+    SizeT parallel_find(const BasicStringSlice<char, SizeT>& slice, char c, Executor& executor) noexcept
+    {
+        return parallel_find(slice, BasicStringSlice<char, SizeT>(&c, 1), executor);
+    }
+
+    /// Find the start positions of every occurrence of needle (including overlapping ones), in order, using the
+    /// given executor. Up to capacity positions are written to out. Returns the total number of matches, which
+    /// may be larger than capacity. Each chunk is scanned twice: once to count its matches, so every chunk knows
+    /// where its results go, and once to write them.
+    template<typename SizeT, typename Executor>
+    SizeT parallel_find_all(const BasicStringSlice<char, SizeT>& slice,
+        const typename detail::ScanSlice<SizeT>::type& needle, SizeT* out,
+        typename detail::ScanSlice<SizeT>::type::size_type capacity, Executor& executor) noexcept
+    {
+        if (needle.empty())
+        {
+            return 0;
+        }
+
+        detail::ParallelChunks chunks(slice, executor);
+        SizeT offsets[detail::parallel_max_tasks + 1];
+
+        executor.run(chunks.count(), [&](unsigned int i) {
+            offsets[i + 1] = detail::parallel_chunk_matches(slice, needle, (SizeT)chunks.begin(i),
+                (SizeT)chunks.end(i), [](SizeT) {});
+        });
+
+        offsets[0] = 0;
+        for (unsigned int i = 0; i < chunks.count(); ++i)
+        {
+            offsets[i + 1] += offsets[i];
+        }
+
+        executor.run(chunks.count(), [&](unsigned int i) {
+            SizeT n = offsets[i];
+            if (n >= capacity)
+            {
+                return;
+            }
+
+            detail::parallel_chunk_matches(slice, needle, (SizeT)chunks.begin(i), (SizeT)chunks.end(i),
+                [&](SizeT pos) {
+                    if (n < capacity)
+                    {
+                        out[n++] = pos;
+                    }
+                });
+        });
+
+        return offsets[chunks.count()];
+    }
+}
+
+#endif // _SCOTTZ0R_PARALLEL_SCAN_INCLUDE_GUARD
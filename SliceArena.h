@@ -0,0 +1,79 @@
+/// @file
+/// Defines the SliceArena object.
+#ifndef _SCOTTZ0R_SLICE_ARENA_INCLUDE_GUARD
+#define _SCOTTZ0R_SLICE_ARENA_INCLUDE_GUARD
+
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+
+namespace scottz0r
+{
+    /// Bump allocator over a caller provided buffer. The index and matcher types that need more than a fixed
+    /// amount of memory take their storage from an arena, so they never allocate from the heap and can be
+    /// placed in static memory on embedded targets. Memory is released all at once with reset, or back to an
+    /// earlier mark with release. This class does not throw exceptions.
+    class SliceArena
+    {
+    public:
+        /// Construct an arena over a buffer. The arena has the same lifetime as the buffer.
+        SliceArena(void* buffer, size_t size) noexcept
+            : m_buffer((char*)buffer), m_size(buffer ? size : 0), m_used(0)
+        {
+        }
+
+        /// @see SliceArena(void*, size_t).
+        template<size_t _Size>
+        SliceArena(char(&buffer)[_Size]) noexcept
+            : SliceArena(buffer, _Size)
+        {
+        }
+
+        /// Allocate an array of count objects. The memory is not initialized. Returns nullptr if there is not
+        /// enough room left. Only trivial types can be allocated, because destructors are never run.
+        template<typename T>
+        T* allocate(size_t count) noexcept
+        {
+            static_assert(std::is_trivially_destructible<T>::value, "Arena objects are never destroyed");
+
+            uintptr_t base = (uintptr_t)m_buffer;
+            size_t start = (size_t)(((base + m_used + alignof(T) - 1) & ~(uintptr_t)(alignof(T) - 1)) - base);
+            if (start > m_size || count > (m_size - start) / sizeof(T))
+            {
+                return nullptr;
+            }
+
+            m_used = start + count * sizeof(T);
+            return (T*)(m_buffer + start);
+        }
+
+        /// Returns the number of bytes in use, including alignment padding. Pass to release to free everything
+        /// allocated after this point.
+        size_t mark() const noexcept { return m_used; }
+
+        /// Release everything allocated after the given mark.
+        void release(size_t mark) noexcept
+        {
+            if (mark < m_used)
+            {
+                m_used = mark;
+            }
+        }
+
+        /// Release everything.
+        void reset() noexcept { m_used = 0; }
+
+        /// Returns the total size of the buffer.
+        size_t capacity() const noexcept { return m_size; }
+
+        /// Returns the number of bytes still available, ignoring alignment.
+        size_t available() const noexcept { return m_size - m_used; }
+
+    private:
+        char* m_buffer;
+        size_t m_size;
+        size_t m_used;
+    };
+}
+
+#endif // _SCOTTZ0R_SLICE_ARENA_INCLUDE_GUARD
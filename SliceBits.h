@@ -0,0 +1,351 @@
+/// @file
+/// Bit manipulation and word-at-a-time (SWAR) helpers shared by StringSlice and the block-at-a-time scanners.
+#ifndef _SCOTTZ0R_SLICE_BITS_INCLUDE_GUARD
+#define _SCOTTZ0R_SLICE_BITS_INCLUDE_GUARD
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__PCLMUL__) && defined(__SSE2__)
+#include <wmmintrin.h>
+#define SCOTTZ0R_SLICE_BITS_HAS_CLMUL 1
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace scottz0r
+{
+    namespace bits
+    {
+        /// Number of bytes processed per block by the bitmask scanners. Each byte maps to one bit of a uint64_t.
+        static constexpr unsigned int block_size = 64;
+
+        /// Count trailing zero bits. The result is undefined if x is 0.
+        inline unsigned int ctz64(uint64_t x) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return (unsigned int)__builtin_ctzll(x);
+#elif defined(_MSC_VER) && defined(_M_X64)
+            unsigned long idx;
+            _BitScanForward64(&idx, x);
+            return (unsigned int)idx;
+#else
+            unsigned int n = 0;
+            while ((x & 1) == 0)
+            {
+                x >>= 1;
+                ++n;
+            }
+            return n;
+#endif
+        }
+
+        /// Count the number of set bits.
+        inline unsigned int popcount64(uint64_t x) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return (unsigned int)__builtin_popcountll(x);
+#else
+            x = x - ((x >> 1) & 0x5555555555555555ull);
+            x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+            x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+            return (unsigned int)((x * 0x0101010101010101ull) >> 56);
+#endif
+        }
+
+        /// Prefix XOR: bit i of the result is the XOR of bits 0 through i of x. Used to turn a mask of quote
+        /// characters into a mask of the regions between quote pairs. Uses carry-less multiplication by all ones
+        /// when PCLMUL is available, and log2(64) shift/xor steps otherwise.
+        inline uint64_t prefix_xor64(uint64_t x) noexcept
+        {
+#if defined(SCOTTZ0R_SLICE_BITS_HAS_CLMUL)
+            __m128i v = _mm_set_epi64x(0, (long long)x);
+            __m128i ones = _mm_set1_epi8((char)0xFF);
+            return (uint64_t)_mm_cvtsi128_si64(_mm_clmulepi64_si128(v, ones, 0));
+#else
+            x ^= x << 1;
+            x ^= x << 2;
+            x ^= x << 4;
+            x ^= x << 8;
+            x ^= x << 16;
+            x ^= x << 32;
+            return x;
+#endif
+        }
+
+        /// Unaligned load of 8 bytes.
+        inline uint64_t load_u64(const char* p) noexcept
+        {
+            uint64_t v;
+            memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        /// Load len bytes (at most 8) into the low bytes of a zeroed word.
+        inline uint64_t load_partial_u64(const char* p, unsigned int len) noexcept
+        {
+            uint64_t v = 0;
+            memcpy(&v, p, len);
+            return v;
+        }
+
+        /// Load 8 bytes so that byte i is bits 8i to 8i + 7 whatever the host byte order. Compiles to a plain load
+        /// on little endian targets.
+        inline uint64_t load_le_u64(const char* p) noexcept
+        {
+            const unsigned char* b = (const unsigned char*)p;
+            return (uint64_t)b[0] | ((uint64_t)b[1] << 8) | ((uint64_t)b[2] << 16) | ((uint64_t)b[3] << 24) |
+                ((uint64_t)b[4] << 32) | ((uint64_t)b[5] << 40) | ((uint64_t)b[6] << 48) | ((uint64_t)b[7] << 56);
+        }
+
+        /// Gather the high bit of each byte of x into 8 bits, byte i to bit i. The other bits of x must be zero,
+        /// as in the result of zero_bytes_exact.
+        inline uint64_t gather_high_bits(uint64_t x) noexcept
+        {
+            return ((x >> 7) * 0x0102040810204080ull) >> 56;
+        }
+        /// Per-lane constants for treating a 64-bit word as 8, 4 or 2 lanes of Width bytes each.
+        template<unsigned int Width>
+        struct Lanes;
+
+        template<>
+        struct Lanes<1>
+        {
+            using lane_type = uint8_t;
+            static constexpr uint64_t ones = 0x0101010101010101ull;
+            static constexpr uint64_t high = 0x8080808080808080ull;
+        };
+
+        template<>
+        struct Lanes<2>
+        {
+            using lane_type = uint16_t;
+            static constexpr uint64_t ones = 0x0001000100010001ull;
+            static constexpr uint64_t high = 0x8000800080008000ull;
+        };
+
+        template<>
+        struct Lanes<4>
+        {
+            using lane_type = uint32_t;
+            static constexpr uint64_t ones = 0x0000000100000001ull;
+            static constexpr uint64_t high = 0x8000000080000000ull;
+        };
+
+        /// Returns a word with the high bit set in each lane of x that is zero. Lanes above the first zero lane may
+        /// also be flagged, so only use the result as a test or to find the lowest zero lane.
+        template<unsigned int Width>
+        inline uint64_t zero_lanes(uint64_t x) noexcept
+        {
+            return (x - Lanes<Width>::ones) & ~x & Lanes<Width>::high;
+        }
+
+        /// Returns a word with the high bit set in exactly the lanes of x that are zero. Slower than zero_lanes,
+        /// but the result can be counted.
+        template<unsigned int Width>
+        inline uint64_t zero_lanes_exact(uint64_t x) noexcept
+        {
+            const uint64_t low = ~Lanes<Width>::high;
+            uint64_t y = ((x & low) + low) | x;
+            return ~y & Lanes<Width>::high;
+        }
+
+        /// Convert the ASCII upper case letters in each lane of x to lower case. Lanes outside 'A' to 'Z',
+        /// including non-ASCII values, are unchanged.
+        template<unsigned int Width>
+        inline uint64_t fold_case_lanes(uint64_t x) noexcept
+        {
+            const uint64_t ones = Lanes<Width>::ones;
+            const uint64_t high = Lanes<Width>::high;
+            const uint64_t top = high / ones;
+            uint64_t low = x & ~high;
+            uint64_t ge_a = low + ones * (top - 'A');
+            uint64_t gt_z = low + ones * (top - 'Z' - 1);
+            uint64_t is_upper = (ge_a ^ gt_z) & ~x & high;
+            return x | (is_upper >> (8 * Width - 6));
+        }
+
+        /// Returns a word with 0x80 set in each byte of x that is zero. Bytes above the first zero byte may also be
+        /// flagged, so only use the result as a test or to find the lowest zero byte.
+        inline uint64_t zero_bytes(uint64_t x) noexcept
+        {
+            return zero_lanes<1>(x);
+        }
+
+        /// Returns a word with 0x80 set in exactly the bytes of x that are zero. Slower than zero_bytes, but the
+        /// result can be counted.
+        inline uint64_t zero_bytes_exact(uint64_t x) noexcept
+        {
+            return zero_lanes_exact<1>(x);
+        }
+
+        /// Convert the ASCII upper case letters in each byte of x to lower case. Bytes outside 'A' to 'Z',
+        /// including non-ASCII bytes, are unchanged.
+        inline uint64_t fold_case_u64(uint64_t x) noexcept
+        {
+            return fold_case_lanes<1>(x);
+        }
+
+        /// Convert an ASCII upper case letter to lower case.
+        template<typename CharT>
+        inline CharT fold_case(CharT c) noexcept
+        {
+            return (c >= 'A' && c <= 'Z') ? (CharT)(c | 0x20) : c;
+        }
+
+        /// A block of up to block_size bytes loaded once and then compared against several characters, one bit of
+        /// the result per byte. The block-at-a-time scanners build their structural masks from it. Uses four SSE2
+        /// compares and movemasks per character when available, and eight SWAR word compares otherwise. Blocks
+        /// shorter than block_size are zero padded and the padding bits are masked off.
+        class ByteBlock
+        {
+        public:
+            ByteBlock(const char* p, unsigned int len) noexcept
+                : m_valid(len >= block_size ? ~0ull : (1ull << len) - 1)
+            {
+                char padded[block_size];
+                if (len < block_size)
+                {
+                    memset(padded, 0, sizeof(padded));
+                    if (len > 0)
+                    {
+                        memcpy(padded, p, len);
+                    }
+                    p = padded;
+                }
+
+#if defined(__SSE2__)
+                for (unsigned int i = 0; i < 4; ++i)
+                {
+                    m_vectors[i] = _mm_loadu_si128((const __m128i*)(p + 16 * i));
+                }
+#else
+                for (unsigned int i = 0; i < 8; ++i)
+                {
+                    m_words[i] = load_le_u64(p + 8 * i);
+                }
+#endif
+            }
+
+            /// Returns a bitmask of the bytes equal to c.
+            uint64_t eq(char c) const noexcept
+            {
+#if defined(__SSE2__)
+                __m128i needle = _mm_set1_epi8(c);
+                uint64_t mask = 0;
+                for (unsigned int i = 0; i < 4; ++i)
+                {
+                    uint64_t bits16 = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(m_vectors[i], needle));
+                    mask |= bits16 << (16 * i);
+                }
+#else
+                uint64_t broadcast = 0x0101010101010101ull * (unsigned char)c;
+                uint64_t mask = 0;
+                for (unsigned int i = 0; i < 8; ++i)
+                {
+                    mask |= gather_high_bits(zero_bytes_exact(m_words[i] ^ broadcast)) << (8 * i);
+                }
+#endif
+                return mask & m_valid;
+            }
+
+            /// Returns a bitmask of the bytes that are in bounds.
+            uint64_t valid() const noexcept { return m_valid; }
+
+        private:
+#if defined(__SSE2__)
+            __m128i m_vectors[4];
+#else
+            uint64_t m_words[8];
+#endif
+            uint64_t m_valid;
+        };
+
+        /// Build a bitmask of the bytes in [p, p + len) that are equal to c. len must be at most block_size. To
+        /// compare one block against several characters, load a ByteBlock once instead.
+        inline uint64_t eq_mask(const char* p, unsigned int len, char c) noexcept
+        {
+            return ByteBlock(p, len).eq(c);
+        }
+
+        /// Number of bytes needed to store v as a varint (7 bits per byte, low bits first, high bit set on every
+        /// byte but the last).
+        inline unsigned int varint_size(uint64_t v) noexcept
+        {
+            unsigned int n = 1;
+            while (v >= 0x80)
+            {
+                v >>= 7;
+                ++n;
+            }
+
+            return n;
+        }
+
+        /// Write v as a varint. Returns a pointer past the last byte written. The buffer must have room for
+        /// varint_size(v) bytes.
+        inline unsigned char* put_varint(unsigned char* p, uint64_t v) noexcept
+        {
+            while (v >= 0x80)
+            {
+                *p++ = (unsigned char)(v | 0x80);
+                v >>= 7;
+            }
+
+            *p++ = (unsigned char)v;
+            return p;
+        }
+
+        /// Read a varint written by put_varint. Returns a pointer past the last byte read. The data must be well
+        /// formed.
+        inline const unsigned char* get_varint(const unsigned char* p, uint64_t& v) noexcept
+        {
+            v = 0;
+            unsigned int shift = 0;
+            while (*p & 0x80)
+            {
+                v |= (uint64_t)(*p++ & 0x7F) << shift;
+                shift += 7;
+            }
+
+            v |= (uint64_t)*p++ << shift;
+            return p;
+        }
+
+        /// Mix one word into a running hash.
+        inline uint64_t hash_mix(uint64_t h, uint64_t w) noexcept
+        {
+            h = (h ^ w) * 0xBF58476D1CE4E5B9ull;
+            return h ^ (h >> 31);
+        }
+
+        /// Final avalanche step of a hash.
+        inline uint64_t hash_finish(uint64_t h) noexcept
+        {
+            h ^= h >> 29;
+            h *= 0x94D049BB133111EBull;
+            return h ^ (h >> 32);
+        }
+
+        /// Hint that the cache line holding p will be read soon. Does nothing on compilers without a prefetch
+        /// intrinsic.
+        inline void prefetch(const void* p) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(p, 0, 3);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+            _mm_prefetch((const char*)p, _MM_HINT_T0);
+#else
+            (void)p;
+#endif
+        }
+    }
+}
+
+#endif // _SCOTTZ0R_SLICE_BITS_INCLUDE_GUARD
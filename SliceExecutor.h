@@ -0,0 +1,224 @@
+/// @file
+/// Executors used by the parallel slice algorithms.
+#ifndef _SCOTTZ0R_SLICE_EXECUTOR_INCLUDE_GUARD
+#define _SCOTTZ0R_SLICE_EXECUTOR_INCLUDE_GUARD
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace scottz0r
+{
+    // An executor is any type with these two members:
+    //
+    //   unsigned int concurrency() const;            Number of tasks that can run at the same time.
+    //   template<typename Fn> void run(unsigned int tasks, Fn&& fn);
+    //                                                Call fn(i) for each i in [0, tasks), possibly concurrently, and
+    //                                                return once every call has finished.
+    //
+    // Wrap your own thread pool in a type like this to use it with the parallel algorithms.
+
+    /// Runs every task on the calling thread.
+    class SerialExecutor
+    {
+    public:
+        unsigned int concurrency() const noexcept { return 1; }
+
+        template<typename Fn>
+        void run(unsigned int tasks, Fn&& fn) noexcept
+        {
+            for (unsigned int i = 0; i < tasks; ++i)
+            {
+                fn(i);
+            }
+        }
+    };
+
+    /// Fixed size thread pool. Tasks are not assigned to threads up front: each thread (including the caller of
+    /// run) claims the next unstarted task from a shared counter, so threads that finish early take over the
+    /// remaining work. run must not be called concurrently or from inside a task.
+    ///
+    /// Unlike the rest of the library, the constructor can throw std::system_error if threads cannot be started, or
+    /// std::bad_alloc.
+    class ThreadPoolExecutor
+    {
+    public:
+        /// Construct with the given total number of threads, including the thread calling run. 0 uses the number
+        /// of hardware threads.
+        explicit ThreadPoolExecutor(unsigned int threads = 0)
+            : m_invoke(nullptr), m_context(nullptr), m_tasks(0), m_generation(0), m_active(0), m_stop(false),
+            m_next(0), m_completed(0)
+        {
+            if (threads == 0)
+            {
+                threads = std::thread::hardware_concurrency();
+            }
+
+            for (unsigned int i = 1; i < threads; ++i)
+            {
+                m_workers.emplace_back([this] { worker_loop(); });
+            }
+        }
+
+        ThreadPoolExecutor(const ThreadPoolExecutor&) = delete;
+        ThreadPoolExecutor& operator=(const ThreadPoolExecutor&) = delete;
+
+        ~ThreadPoolExecutor()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+            }
+
+            m_wake.notify_all();
+
+            for (std::thread& t : m_workers)
+            {
+                t.join();
+            }
+        }
+
+        unsigned int concurrency() const noexcept { return (unsigned int)m_workers.size() + 1; }
+
+        template<typename Fn>
+        void run(unsigned int tasks, Fn&& fn) noexcept
+        {
+            if (tasks == 0)
+            {
+                return;
+            }
+
+            using FnType = typename std::remove_reference<Fn>::type;
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_invoke = [](void* context, unsigned int i) { (*(FnType*)context)(i); };
+                m_context = (void*)&fn;
+                m_tasks = tasks;
+                m_next.store(0);
+                m_completed.store(0);
+                ++m_generation;
+            }
+
+            m_wake.notify_all();
+
+            claim_tasks(m_invoke, m_context, tasks);
+
+            // Wait for the other threads to finish their tasks and stop claiming, so a stale thread cannot claim
+            // a task from the next run.
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_done.wait(lock, [&] { return m_completed.load() == tasks && m_active == 0; });
+
+            // A thread that wakes up late must not pick up this job.
+            m_tasks = 0;
+        }
+
+    private:
+        using Invoke = void (*)(void*, unsigned int);
+
+        void claim_tasks(Invoke invoke, void* context, unsigned int tasks) noexcept
+        {
+            unsigned int i;
+            while ((i = m_next.fetch_add(1)) < tasks)
+            {
+                invoke(context, i);
+                m_completed.fetch_add(1);
+            }
+        }
+
+        void worker_loop() noexcept
+        {
+            unsigned long long seen = 0;
+
+            for (;;)
+            {
+                Invoke invoke;
+                void* context;
+                unsigned int tasks;
+
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_wake.wait(lock, [&] { return m_stop || m_generation != seen; });
+
+                    if (m_stop)
+                    {
+                        return;
+                    }
+
+                    seen = m_generation;
+                    invoke = m_invoke;
+                    context = m_context;
+                    tasks = m_tasks;
+
+                    if (tasks == 0)
+                    {
+                        continue;
+                    }
+
+                    ++m_active;
+                }
+
+                claim_tasks(invoke, context, tasks);
+
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    --m_active;
+                }
+
+                m_done.notify_all();
+            }
+        }
+
+        std::vector<std::thread> m_workers;
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_done;
+
+        // Guarded by m_mutex.
+        Invoke m_invoke;
+        void* m_context;
+        unsigned int m_tasks;
+        unsigned long long m_generation;
+        unsigned int m_active;
+        bool m_stop;
+
+        std::atomic<unsigned int> m_next;
+        std::atomic<unsigned int> m_completed;
+    };
+
+    /// Call fn(i) for each i in [0, tasks) with executor.run, and once every call has finished, rethrow the first
+    /// exception a call threw on the calling thread. run itself is noexcept, so an exception escaping a task would
+    /// call std::terminate. The algorithms whose tasks allocate or call user code run them through this.
+    template<typename Executor, typename Fn>
+    void run_rethrow(Executor& executor, unsigned int tasks, Fn&& fn)
+    {
+        std::mutex mutex;
+        std::exception_ptr error;
+
+        executor.run(tasks, [&](unsigned int i) {
+            try
+            {
+                fn(i);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error)
+                {
+                    error = std::current_exception();
+                }
+            }
+        });
+
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+#endif // _SCOTTZ0R_SLICE_EXECUTOR_INCLUDE_GUARD
@@ -0,0 +1,204 @@
+/// @file
+/// Parallel distinct counting and frequency tables of StringSlice arrays.
+#ifndef _SCOTTZ0R_SLICE_FREQUENCY_INCLUDE_GUARD
+#define _SCOTTZ0R_SLICE_FREQUENCY_INCLUDE_GUARD
+
+#include <algorithm>
+#include <vector>
+
+#include "StringSlice.h"
+#include "SliceExecutor.h"
+
+namespace scottz0r
+{
+    /// A distinct slice and the number of times it occurs. The slice is one of the input slices; no bytes are
+    /// copied.
+    struct SliceCount
+    {
+        StringSlice slice;
+        size_t count;
+    };
+
+    namespace detail
+    {
+        /// Upper bound on the number of input chunks and hash partitions.
+        static constexpr unsigned int frequency_max_tasks = 256;
+
+        /// Inputs smaller than this are not split into chunks.
+        static constexpr size_t frequency_min_chunk = 16 * 1024;
+
+        /// Count the distinct slices in [first, last). Each hash partition p writes its distinct slices to
+        /// counts starting at starts[p], and their number to sizes[p].
+        ///
+        /// First each input chunk hashes its slices and counts how many fall in each partition, selected by the
+        /// top bits of the hash. A prefix sum over (partition, chunk) gives every chunk its own output range in
+        /// each partition, so the scatter into partition order needs no locking. Then each partition is counted
+        /// on its own in an open addressing table that holds only that partition's keys, which stays far smaller
+        /// than a table of all keys.
+        ///
+        /// All memory is allocated on the calling thread before the tasks that use it run, so an allocation
+        /// failure throws std::bad_alloc here instead of ending the process from inside a noexcept run.
+        template<typename Executor>
+        void partitioned_frequency(const StringSlice* first, const StringSlice* last, Executor& executor,
+            std::vector<SliceCount>& counts, std::vector<size_t>& starts, std::vector<size_t>& sizes)
+        {
+            struct Entry
+            {
+                uint64_t hash;
+                const StringSlice* slice;
+            };
+
+            size_t n = last > first ? (size_t)(last - first) : 0;
+            unsigned int wanted = executor.concurrency() * 4;
+            wanted = wanted < frequency_max_tasks ? wanted : frequency_max_tasks;
+
+            unsigned int partition_bits = 0;
+            while ((1u << partition_bits) < wanted && n > ((size_t)frequency_min_chunk << partition_bits))
+            {
+                ++partition_bits;
+            }
+
+            unsigned int partitions = 1u << partition_bits;
+            size_t by_size = n / frequency_min_chunk;
+            unsigned int chunks = by_size < wanted ? (by_size > 1 ? (unsigned int)by_size : 1) : wanted;
+
+            std::vector<uint64_t> hashes(n);
+            std::vector<Entry> entries(n);
+            std::vector<size_t> offsets((size_t)chunks * partitions + 1);
+            counts.assign(n, SliceCount{ StringSlice(), 0 });
+            starts.assign(partitions, 0);
+            sizes.assign(partitions, 0);
+            auto partition_of = [&](uint64_t hash) {
+                return partition_bits == 0 ? 0u : (unsigned int)(hash >> (64 - partition_bits));
+            };
+
+            // offsets[p * chunks + c] counts chunk c's keys in partition p, then becomes its output start.
+            executor.run(chunks, [&](unsigned int c) {
+                for (size_t i = n * c / chunks; i < n * (c + 1) / chunks; ++i)
+                {
+                    hashes[i] = first[i].hash();
+                    ++offsets[(size_t)partition_of(hashes[i]) * chunks + c];
+                }
+            });
+
+            size_t total = 0;
+            for (size_t k = 0; k < offsets.size(); ++k)
+            {
+                size_t count = offsets[k];
+                offsets[k] = total;
+                total += count;
+            }
+
+            executor.run(chunks, [&](unsigned int c) {
+                size_t next[frequency_max_tasks];
+                for (unsigned int p = 0; p < partitions; ++p)
+                {
+                    next[p] = offsets[(size_t)p * chunks + c];
+                }
+
+                for (size_t i = n * c / chunks; i < n * (c + 1) / chunks; ++i)
+                {
+                    entries[next[partition_of(hashes[i])]++] = Entry{ hashes[i], first + i };
+                }
+            });
+
+            // Each partition's table is a power of two at least twice its key count. Slots hold an index into
+            // counts plus one, so 0 is empty.
+            std::vector<size_t> table_starts(partitions + 1);
+            for (unsigned int p = 0; p < partitions; ++p)
+            {
+                size_t keys = offsets[(size_t)(p + 1) * chunks] - offsets[(size_t)p * chunks];
+                size_t capacity = 16;
+                while (capacity < keys * 2)
+                {
+                    capacity *= 2;
+                }
+
+                table_starts[p + 1] = table_starts[p] + capacity;
+            }
+
+            std::vector<size_t> slots(table_starts[partitions]);
+            std::vector<uint64_t> slot_hashes(table_starts[partitions]);
+
+            executor.run(partitions, [&](unsigned int p) {
+                size_t begin = offsets[(size_t)p * chunks];
+                size_t end = offsets[(size_t)(p + 1) * chunks];
+                size_t* table = slots.data() + table_starts[p];
+                uint64_t* table_hashes = slot_hashes.data() + table_starts[p];
+                size_t mask = table_starts[p + 1] - table_starts[p] - 1;
+
+                // A partition has at most end - begin distinct keys, so its output fits in its input range.
+                SliceCount* out = counts.data() + begin;
+                size_t distinct = 0;
+
+                for (size_t i = begin; i < end; ++i)
+                {
+                    const Entry& e = entries[i];
+                    size_t s = (size_t)e.hash & mask;
+                    while (table[s] != 0 && (table_hashes[s] != e.hash || out[table[s] - 1].slice != *e.slice))
+                    {
+                        s = (s + 1) & mask;
+                    }
+
+                    if (table[s] == 0)
+                    {
+                        out[distinct] = SliceCount{ *e.slice, 0 };
+                        table[s] = ++distinct;
+                        table_hashes[s] = e.hash;
+                    }
+
+                    ++out[table[s] - 1].count;
+                }
+
+                starts[p] = begin;
+                sizes[p] = distinct;
+            });
+        }
+    }
+
+    /// Count how many times each distinct slice occurs in [first, last) using the given executor (see
+    /// SliceExecutor.h). Returns one entry per distinct slice, grouped by hash partition and otherwise in order
+    /// of first occurrence. The returned slices point at the same bytes as the input. Work memory is 80 to 112
+    /// bytes per input slice, allocated from the heap on the calling thread before any task runs, so this throws
+    /// std::bad_alloc if it is not available. The tasks themselves do not allocate.
+    template<typename Executor>
+    std::vector<SliceCount> frequency_table(const StringSlice* first, const StringSlice* last, Executor& executor)
+    {
+        std::vector<SliceCount> counts;
+        std::vector<size_t> starts;
+        std::vector<size_t> sizes;
+        detail::partitioned_frequency(first, last, executor, counts, starts, sizes);
+
+        // Close the gaps between partitions. Each range moves down, so it never overwrites one not yet moved.
+        size_t total = 0;
+        for (size_t p = 0; p < starts.size(); ++p)
+        {
+            std::copy(counts.begin() + starts[p], counts.begin() + starts[p] + sizes[p], counts.begin() + total);
+            total += sizes[p];
+        }
+
+        counts.resize(total);
+        return counts;
+    }
+
+    /// Returns the number of distinct slices in [first, last) using the given executor (see SliceExecutor.h).
+    /// Same work and memory as frequency_table, and throws std::bad_alloc the same way.
+    template<typename Executor>
+    size_t count_distinct(const StringSlice* first, const StringSlice* last, Executor& executor)
+    {
+        std::vector<SliceCount> counts;
+        std::vector<size_t> starts;
+        std::vector<size_t> sizes;
+        detail::partitioned_frequency(first, last, executor, counts, starts, sizes);
+
+        size_t total = 0;
+        for (size_t size : sizes)
+        {
+            total += size;
+        }
+
+        return total;
+    }
+}
+
+#endif // _SCOTTZ0R_SLICE_FREQUENCY_INCLUDE_GUARD
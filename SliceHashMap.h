@@ -0,0 +1,219 @@
+/// @file
+/// Defines the SliceHashMap object.
+#ifndef _SCOTTZ0R_SLICE_HASH_MAP_INCLUDE_GUARD
+#define _SCOTTZ0R_SLICE_HASH_MAP_INCLUDE_GUARD
+
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+
+#include "StringSlice.h"
+#include "SliceArena.h"
+
+namespace scottz0r
+{
+    /// Fixed capacity hash map from strings to values, using open addressing with linear probing. Each slot holds
+    /// the full 64-bit hash, the key and the value, so a probe compares key bytes only when the hashes match.
+    ///
+    /// Lookups into a table larger than the cache spend most of their time waiting on the one miss for the slot.
+    /// lookup_batch hides that latency by working on groups of keys: it hashes every key of a group and
+    /// prefetches its slot, then probes them all, so up to batch_group misses are in flight at once.
+    ///
+    /// Slots and copies of the keys are allocated from a SliceArena. Values must be trivially copyable, because
+    /// the arena never runs destructors. This class does not throw exceptions.
+    template<typename V>
+    class SliceHashMap
+    {
+        static_assert(std::is_trivially_copyable<V>::value, "Hash map values must be trivially copyable");
+
+    public:
+        using size_type = StringSlice::size_type;
+
+        /// Number of keys lookup_batch hashes and prefetches before probing.
+        static constexpr size_t batch_group = 16;
+
+        /// Construct an empty map without storage. Inserts fail.
+        SliceHashMap() noexcept
+            : m_arena(nullptr), m_slots(nullptr), m_mask(0), m_max_size(0), m_count(0)
+        {
+        }
+
+        /// Construct an empty map for up to max_size keys. The slot array, a power of two at least 1.25 times
+        /// max_size, is allocated from the arena now, and keys are copied into it as they are added. Check valid
+        /// to see if the slots fit.
+        SliceHashMap(SliceArena& arena, size_t max_size) noexcept
+            : SliceHashMap()
+        {
+            size_t slot_count = 2;
+            while (slot_count < max_size + max_size / 4 + 1)
+            {
+                slot_count *= 2;
+            }
+
+            m_slots = arena.template allocate<Slot>(slot_count);
+            if (m_slots)
+            {
+                memset((void*)m_slots, 0, slot_count * sizeof(Slot));
+                m_arena = &arena;
+                m_mask = slot_count - 1;
+                m_max_size = max_size;
+            }
+        }
+
+        /// Returns true if the map has storage.
+        bool valid() const noexcept { return m_slots != nullptr; }
+
+        /// Returns the number of keys.
+        size_t size() const noexcept { return m_count; }
+
+        /// Returns true if the map has no keys.
+        bool empty() const noexcept { return m_count == 0; }
+
+        /// Returns the most keys the map can hold.
+        size_t max_size() const noexcept { return m_max_size; }
+
+        /// Add a key, or replace its value if it is already in the map. Returns false if the map is full or the
+        /// arena is too small for the key, in which case the map is unchanged.
+        bool insert(const StringSlice& key, const V& value) noexcept
+        {
+            if (!m_slots)
+            {
+                return false;
+            }
+
+            uint64_t hash = slot_hash(key);
+            size_t i = (size_t)hash & m_mask;
+            while (m_slots[i].hash != 0)
+            {
+                if (m_slots[i].hash == hash && m_slots[i].key == key)
+                {
+                    memcpy((void*)&m_slots[i].value, (const void*)&value, sizeof(V));
+                    return true;
+                }
+
+                i = (i + 1) & m_mask;
+            }
+
+            if (m_count == m_max_size)
+            {
+                return false;
+            }
+
+            char* bytes = nullptr;
+            if (key.size() > 0)
+            {
+                bytes = m_arena->template allocate<char>(key.size());
+                if (!bytes)
+                {
+                    return false;
+                }
+
+                memcpy(bytes, key.data(), key.size());
+            }
+
+            m_slots[i].hash = hash;
+            m_slots[i].key = StringSlice(bytes, key.size());
+            memcpy((void*)&m_slots[i].value, (const void*)&value, sizeof(V));
+            ++m_count;
+            return true;
+        }
+
+        /// Get the value of a key. Returns nullptr if the key is not in the map.
+        const V* find(const StringSlice& key) const noexcept
+        {
+            return m_slots ? probe(key, slot_hash(key)) : nullptr;
+        }
+
+        /// @see find(const StringSlice&) const.
+        V* find(const StringSlice& key) noexcept
+        {
+            return const_cast<V*>(static_cast<const SliceHashMap*>(this)->find(key));
+        }
+
+        /// Returns true if the key is in the map.
+        bool contains(const StringSlice& key) const noexcept { return find(key) != nullptr; }
+
+        /// Look up n keys at once. out[i] receives the value of keys[i], or nullptr if it is not in the map.
+        /// Returns the number of keys found. Same results as calling find for each key, but much faster for
+        /// tables larger than the cache, since the slot loads of a whole group overlap.
+        size_t lookup_batch(const StringSlice* keys, size_t n, const V** out) const noexcept
+        {
+            if (!m_slots)
+            {
+                for (size_t i = 0; i < n; ++i)
+                {
+                    out[i] = nullptr;
+                }
+                return 0;
+            }
+
+            size_t found = 0;
+            uint64_t hashes[batch_group];
+            for (size_t first = 0; first < n; first += batch_group)
+            {
+                size_t group = n - first < batch_group ? n - first : batch_group;
+                for (size_t i = 0; i < group; ++i)
+                {
+                    hashes[i] = slot_hash(keys[first + i]);
+                    bits::prefetch(&m_slots[(size_t)hashes[i] & m_mask]);
+                }
+
+                for (size_t i = 0; i < group; ++i)
+                {
+                    const V* value = probe(keys[first + i], hashes[i]);
+                    out[first + i] = value;
+                    found += value ? 1 : 0;
+                }
+            }
+
+            return found;
+        }
+
+        /// @see lookup_batch(const StringSlice*, size_t, const V**) const.
+        template<size_t _Size>
+        size_t lookup_batch(const StringSlice(&keys)[_Size], const V* (&out)[_Size]) const noexcept
+        {
+            return lookup_batch(keys, _Size, out);
+        }
+
+    private:
+        struct Slot
+        {
+            /// Hash of the key with the top bit set, or 0 for an empty slot.
+            uint64_t hash;
+            StringSlice key;
+            V value;
+        };
+
+        static uint64_t slot_hash(const StringSlice& key) noexcept
+        {
+            return key.hash() | (1ull << 63);
+        }
+
+        /// Linear probe from the key's home slot. There is always an empty slot, because the slot count is more
+        /// than max_size.
+        const V* probe(const StringSlice& key, uint64_t hash) const noexcept
+        {
+            size_t i = (size_t)hash & m_mask;
+            while (m_slots[i].hash != 0)
+            {
+                if (m_slots[i].hash == hash && m_slots[i].key == key)
+                {
+                    return &m_slots[i].value;
+                }
+
+                i = (i + 1) & m_mask;
+            }
+
+            return nullptr;
+        }
+
+        SliceArena* m_arena;
+        Slot* m_slots;
+        size_t m_mask;
+        size_t m_max_size;
+        size_t m_count;
+    };
+}
+
+#endif // _SCOTTZ0R_SLICE_HASH_MAP_INCLUDE_GUARD
@@ -0,0 +1,329 @@
+/// @file
+/// Sorting of StringSlice arrays by MSD radix sort and multikey quicksort.
+#ifndef _SCOTTZ0R_SLICE_SORT_INCLUDE_GUARD
+#define _SCOTTZ0R_SLICE_SORT_INCLUDE_GUARD
+
+#include <algorithm>
+#include <limits.h>
+#include <vector>
+
+#include "StringSlice.h"
+#include "SliceExecutor.h"
+
+namespace scottz0r
+{
+    namespace detail
+    {
+        /// Ranges this size or smaller are sorted with multikey quicksort instead of radix passes.
+        static constexpr size_t sort_quicksort_max = 64;
+
+        /// Ranges this size or smaller are sorted with insertion sort.
+        static constexpr size_t sort_insertion_max = 8;
+
+        /// Arrays with more keys than this are sorted in parallel.
+        static constexpr size_t sort_parallel_min = 1 << 20;
+
+        /// Upper bound on the number of chunks the parallel counting pass is split into.
+        static constexpr unsigned int sort_max_chunks = 256;
+
+        /// Number of radix buckets: one for keys that end before the current depth, and one per byte value.
+        static constexpr unsigned int sort_buckets = 257;
+
+        /// Sort key of the character at depth, or 0 if the slice ends first. Characters are ordered the same way
+        /// as StringSlice::compare, which compares char values and so depends on whether char is signed.
+        inline unsigned int sort_key(const StringSlice& s, StringSlice::size_type depth) noexcept
+        {
+            return depth < s.size() ? 1u + ((unsigned char)s[depth] ^ (CHAR_MIN < 0 ? 0x80u : 0u)) : 0u;
+        }
+
+        /// Compare two slices that are known to be equal before depth.
+        inline bool sort_less(const StringSlice& a, const StringSlice& b, StringSlice::size_type depth) noexcept
+        {
+            return a.substr(depth) < b.substr(depth);
+        }
+
+        inline void insertion_sort(StringSlice* first, StringSlice* last, StringSlice::size_type depth) noexcept
+        {
+            for (StringSlice* i = first + 1; i < last; ++i)
+            {
+                StringSlice v = *i;
+                StringSlice* j = i;
+                while (j > first && sort_less(v, j[-1], depth))
+                {
+                    *j = j[-1];
+                    --j;
+                }
+
+                *j = v;
+            }
+        }
+
+        /// Bentley-Sedgewick multikey quicksort: three way partition on the character at depth, then sort the
+        /// equal part on the next character. The largest part is handled by the loop to bound the recursion.
+        inline void multikey_quicksort(StringSlice* first, StringSlice* last, StringSlice::size_type depth) noexcept
+        {
+            for (;;)
+            {
+                size_t n = (size_t)(last - first);
+                if (n <= sort_insertion_max)
+                {
+                    if (n > 1)
+                    {
+                        insertion_sort(first, last, depth);
+                    }
+
+                    return;
+                }
+
+                // Median of three.
+                unsigned int a = sort_key(first[0], depth);
+                unsigned int b = sort_key(first[n / 2], depth);
+                unsigned int c = sort_key(last[-1], depth);
+                unsigned int pivot = a < b ? (b < c ? b : (a < c ? c : a)) : (a < c ? a : (b < c ? c : b));
+
+                size_t lt = 0;
+                size_t i = 0;
+                size_t gt = n;
+                while (i < gt)
+                {
+                    unsigned int k = sort_key(first[i], depth);
+                    if (k < pivot)
+                    {
+                        std::swap(first[lt++], first[i++]);
+                    }
+                    else if (k > pivot)
+                    {
+                        std::swap(first[i], first[--gt]);
+                    }
+                    else
+                    {
+                        ++i;
+                    }
+                }
+
+                // Keys in the equal part that ended are all equal, so that part is done.
+                struct Part { StringSlice* first; StringSlice* last; StringSlice::size_type depth; };
+                Part parts[3] = {
+                    { first, first + lt, depth },
+                    { first + lt, pivot == 0 ? first + lt : first + gt, depth + 1 },
+                    { first + gt, last, depth },
+                };
+
+                unsigned int largest = 0;
+                for (unsigned int p = 1; p < 3; ++p)
+                {
+                    if (parts[p].last - parts[p].first > parts[largest].last - parts[largest].first)
+                    {
+                        largest = p;
+                    }
+                }
+
+                for (unsigned int p = 0; p < 3; ++p)
+                {
+                    if (p != largest)
+                    {
+                        multikey_quicksort(parts[p].first, parts[p].last, parts[p].depth);
+                    }
+                }
+
+                first = parts[largest].first;
+                last = parts[largest].last;
+                depth = parts[largest].depth;
+            }
+        }
+
+        /// Move each key into its bucket in place (American flag sort), given the bucket sizes. key(i) returns the
+        /// bucket of the key at index i, and swap(i, j) swaps two keys. bounds receives the start of each bucket
+        /// and the end of the last one.
+        template<typename Key, typename Swap>
+        inline void flag_permute(const size_t* counts, size_t* bounds, Key&& key, Swap&& swap) noexcept
+        {
+            size_t next[sort_buckets];
+            bounds[0] = 0;
+            for (unsigned int b = 0; b < sort_buckets; ++b)
+            {
+                next[b] = bounds[b];
+                bounds[b + 1] = bounds[b] + counts[b];
+            }
+
+            for (unsigned int b = 0; b < sort_buckets; ++b)
+            {
+                while (next[b] < bounds[b + 1])
+                {
+                    // Follow the cycle starting here until a key that belongs in bucket b comes back.
+                    unsigned int k = key(next[b]);
+                    while (k != b)
+                    {
+                        swap(next[b], next[k]++);
+                        k = key(next[b]);
+                    }
+
+                    ++next[b];
+                }
+            }
+        }
+
+        /// MSD radix sort of keys that are equal before depth. Runs of keys with the same next character are
+        /// skipped without moving anything. Each bucket but the largest is sorted recursively, and the largest by
+        /// the loop, so recursion depth is logarithmic in the number of keys.
+        inline void radix_sort(StringSlice* first, StringSlice* last, StringSlice::size_type depth) noexcept
+        {
+            for (;;)
+            {
+                size_t n = (size_t)(last - first);
+                if (n <= sort_quicksort_max)
+                {
+                    multikey_quicksort(first, last, depth);
+                    return;
+                }
+
+                size_t counts[sort_buckets] = {};
+                for (size_t i = 0; i < n; ++i)
+                {
+                    ++counts[sort_key(first[i], depth)];
+                }
+
+                if (counts[0] == n)
+                {
+                    return;
+                }
+
+                if (counts[sort_key(first[0], depth)] == n)
+                {
+                    ++depth;
+                    continue;
+                }
+
+                size_t bounds[sort_buckets + 1];
+                flag_permute(counts, bounds,
+                    [&](size_t i) { return sort_key(first[i], depth); },
+                    [&](size_t i, size_t j) { std::swap(first[i], first[j]); });
+
+                // Bucket 0 holds keys that ended, which are all equal.
+                unsigned int largest = 1;
+                for (unsigned int b = 2; b < sort_buckets; ++b)
+                {
+                    largest = counts[b] > counts[largest] ? b : largest;
+                }
+
+                for (unsigned int b = 1; b < sort_buckets; ++b)
+                {
+                    if (b != largest && counts[b] > 1)
+                    {
+                        radix_sort(first + bounds[b], first + bounds[b + 1], depth + 1);
+                    }
+                }
+
+                last = first + bounds[largest + 1];
+                first = first + bounds[largest];
+                ++depth;
+            }
+        }
+    }
+
+    /// Sort an array of slices into the same order as std::sort with operator<. Uses MSD radix sort, so common
+    /// prefixes are only looked at once per key instead of once per comparison, and multikey quicksort for
+    /// buckets of 64 keys or less. Sorts in place without allocating. Not stable; only the slices are moved,
+    /// never the bytes they point to.
+    inline void sort_slices(StringSlice* first, StringSlice* last) noexcept
+    {
+        if (last - first > 1)
+        {
+            detail::radix_sort(first, last, 0);
+        }
+    }
+
+    /// Sort an array of slices using the given executor (see SliceExecutor.h). Arrays of more than 1M keys are
+    /// split into radix buckets until there are several buckets per thread, with the character counting done in
+    /// parallel and each key's current character cached for the permutation. The buckets are then sorted as
+    /// separate tasks. Smaller arrays are sorted as with sort_slices(first, last). The cache and bucket lists
+    /// are allocated, so this can throw std::bad_alloc.
+    template<typename Executor>
+    void sort_slices(StringSlice* first, StringSlice* last, Executor& executor)
+    {
+        size_t n = last > first ? (size_t)(last - first) : 0;
+        unsigned int threads = executor.concurrency();
+        if (n <= detail::sort_parallel_min || threads <= 1)
+        {
+            sort_slices(first, last);
+            return;
+        }
+
+        struct Range
+        {
+            size_t begin;
+            size_t end;
+            StringSlice::size_type depth;
+        };
+
+        std::vector<uint16_t> keys(n);
+        std::vector<Range> pending(1, Range{ 0, n, 0 });
+        std::vector<Range> tasks;
+        size_t target = n / ((size_t)threads * 8);
+
+        unsigned int chunks = threads * 4 < detail::sort_max_chunks ? threads * 4 : detail::sort_max_chunks;
+        std::vector<size_t> chunk_counts((size_t)chunks * detail::sort_buckets);
+
+        while (!pending.empty())
+        {
+            Range r = pending.back();
+            pending.pop_back();
+
+            size_t size = r.end - r.begin;
+            if (size <= target)
+            {
+                tasks.push_back(r);
+                continue;
+            }
+
+            // Count in parallel, caching each key's character.
+            StringSlice* base = first + r.begin;
+            uint16_t* cache = keys.data() + r.begin;
+            std::fill(chunk_counts.begin(), chunk_counts.end(), 0);
+            executor.run(chunks, [&](unsigned int c) {
+                size_t* counts = chunk_counts.data() + (size_t)c * detail::sort_buckets;
+                for (size_t i = size * c / chunks; i < size * (c + 1) / chunks; ++i)
+                {
+                    cache[i] = (uint16_t)detail::sort_key(base[i], r.depth);
+                    ++counts[cache[i]];
+                }
+            });
+
+            size_t counts[detail::sort_buckets] = {};
+            for (unsigned int c = 0; c < chunks; ++c)
+            {
+                for (unsigned int b = 0; b < detail::sort_buckets; ++b)
+                {
+                    counts[b] += chunk_counts[(size_t)c * detail::sort_buckets + b];
+                }
+            }
+
+            size_t bounds[detail::sort_buckets + 1];
+            detail::flag_permute(counts, bounds,
+                [&](size_t i) { return (unsigned int)cache[i]; },
+                [&](size_t i, size_t j) {
+                    std::swap(base[i], base[j]);
+                    std::swap(cache[i], cache[j]);
+                });
+
+            for (unsigned int b = 1; b < detail::sort_buckets; ++b)
+            {
+                if (counts[b] > 1)
+                {
+                    pending.push_back(Range{ r.begin + bounds[b], r.begin + bounds[b + 1], r.depth + 1 });
+                }
+            }
+        }
+
+        // Largest first, so the small ones fill in at the end.
+        std::sort(tasks.begin(), tasks.end(), [](const Range& a, const Range& b) {
+            return a.end - a.begin > b.end - b.begin;
+        });
+
+        executor.run((unsigned int)tasks.size(), [&](unsigned int i) {
+            detail::radix_sort(first + tasks[i].begin, first + tasks[i].end, tasks[i].depth);
+        });
+    }
+}
+
+#endif // _SCOTTZ0R_SLICE_SORT_INCLUDE_GUARD
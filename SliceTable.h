@@ -0,0 +1,264 @@
+/// @file
+/// Defines the SliceTable and OffsetSliceTable objects.
+#ifndef _SCOTTZ0R_SLICE_TABLE_INCLUDE_GUARD
+#define _SCOTTZ0R_SLICE_TABLE_INCLUDE_GUARD
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "StringSlice.h"
+
+namespace scottz0r
+{
+    namespace detail
+    {
+        /// Get the offset of a token from the start of base. Returns false if the token is not inside base.
+        inline bool slice_offset(const StringSlice64& base, const StringSlice& token, uint64_t& offset) noexcept
+        {
+            uintptr_t begin = (uintptr_t)base.data();
+            uintptr_t p = (uintptr_t)token.data();
+            if (p < begin || p - begin > base.size() || token.size() > base.size() - (p - begin))
+            {
+                return false;
+            }
+
+            offset = (uint64_t)(p - begin);
+            return true;
+        }
+
+        /// Append each field of text split on delimiter to a table. n delimiters give n + 1 fields, including
+        /// empty ones. Stops and returns false at the first field that cannot be added.
+        template<typename Table>
+        bool append_split(Table& table, const StringSlice& text, char delimiter) noexcept
+        {
+            StringSlice::size_type start = 0;
+            for (;;)
+            {
+                StringSlice::size_type end = text.find(delimiter, start);
+                end = end == StringSlice::npos ? text.size() : end;
+
+                if (!table.append(StringSlice(text.data() + start, end - start)))
+                {
+                    return false;
+                }
+
+                if (end == text.size())
+                {
+                    return true;
+                }
+
+                start = end + 1;
+            }
+        }
+    }
+
+    /// Table of tokens stored as packed (offset, length) pairs relative to a base buffer, in one uint64_t each
+    /// instead of a 16 byte StringSlice. The low OffsetBits bits hold the offset and the rest hold the length:
+    /// PackedSliceTable<32> (SliceTable) allows 4 GiB bases and 4 GiB tokens, and PackedSliceTable<40>
+    /// (SliceTable40) allows 1 TiB bases and 16 MiB tokens. Tokens may be in any order and may overlap.
+    ///
+    /// Storage is provided by the caller, one entry per token. This class does not throw exceptions. The table has
+    /// the same lifetime as the base buffer and storage.
+    template<unsigned int OffsetBits>
+    class PackedSliceTable
+    {
+        static_assert(OffsetBits >= 32 && OffsetBits < 64, "Offsets must be 32 to 63 bits");
+
+    public:
+        /// Largest offset that can be stored.
+        static constexpr uint64_t max_offset = (1ull << OffsetBits) - 1;
+
+        /// Largest token that can be stored.
+        static constexpr uint64_t max_length = (~0ull >> OffsetBits) < StringSlice::npos ?
+            (~0ull >> OffsetBits) : StringSlice::npos;
+
+        /// Construct an empty table.
+        PackedSliceTable() noexcept
+            : m_entries(nullptr), m_capacity(0), m_count(0)
+        {
+        }
+
+        /// Construct an empty table for tokens of base, using the given storage.
+        PackedSliceTable(const StringSlice64& base, uint64_t* entries, size_t capacity) noexcept
+            : m_base(base), m_entries(entries), m_capacity(entries ? capacity : 0), m_count(0)
+        {
+        }
+
+        /// @see PackedSliceTable(const StringSlice64&, uint64_t*, size_t).
+        template<size_t _Size>
+        PackedSliceTable(const StringSlice64& base, uint64_t(&entries)[_Size]) noexcept
+            : PackedSliceTable(base, entries, _Size)
+        {
+        }
+
+        /// Append a token. Returns false if the table is full, or if the token is not inside the base buffer or
+        /// does not fit the layout.
+        bool append(const StringSlice& token) noexcept
+        {
+            uint64_t offset;
+            if (m_count == m_capacity || !detail::slice_offset(m_base, token, offset) || offset > max_offset ||
+                token.size() > max_length)
+            {
+                return false;
+            }
+
+            m_entries[m_count++] = offset | ((uint64_t)token.size() << OffsetBits);
+            return true;
+        }
+
+        /// Append every token in [first, last). Stops and returns false at the first token that cannot be added;
+        /// the tokens before it stay in the table.
+        template<typename Iterator>
+        bool append(Iterator first, Iterator last) noexcept
+        {
+            for (; first != last; ++first)
+            {
+                if (!append(*first))
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        /// Append each field of text split on delimiter. n delimiters give n + 1 fields, including empty ones.
+        /// Stops and returns false at the first field that cannot be added.
+        bool append_split(const StringSlice& text, char delimiter) noexcept
+        {
+            return detail::append_split(*this, text, delimiter);
+        }
+
+        /// Remove all tokens.
+        void clear() noexcept { m_count = 0; }
+
+        /// Returns the base buffer.
+        const StringSlice64& base() const noexcept { return m_base; }
+
+        /// Returns the number of tokens.
+        size_t size() const noexcept { return m_count; }
+
+        /// Returns the maximum number of tokens.
+        size_t capacity() const noexcept { return m_capacity; }
+
+        /// Get the token at the given index without range checking.
+        StringSlice operator[](size_t i) const noexcept
+        {
+            uint64_t entry = m_entries[i];
+            return StringSlice(m_base.data() + (entry & max_offset), (StringSlice::size_type)(entry >> OffsetBits));
+        }
+
+    private:
+        StringSlice64 m_base;
+        uint64_t* m_entries;
+        size_t m_capacity;
+        size_t m_count;
+    };
+
+    /// Table of tokens as 32-bit offset and 32-bit length pairs. Base buffers and tokens up to 4 GiB.
+    using SliceTable = PackedSliceTable<32>;
+
+    /// Table of tokens as 40-bit offset and 24-bit length pairs. Base buffers up to 1 TiB, tokens up to 16 MiB.
+    using SliceTable40 = PackedSliceTable<40>;
+
+    /// Table of back to back tokens stored CSR style: only the offset where each token starts, plus one for the
+    /// end of the last token, at 4 bytes per token. Each token must start right after the previous one plus a
+    /// fixed separator size, such as the fields of a split on a one byte delimiter (separator 1) or strings
+    /// packed into a pool (separator 0). The base buffer must be less than 4 GiB.
+    ///
+    /// Storage is provided by the caller, one entry per token plus one. This class does not throw exceptions.
+    /// The table has the same lifetime as the base buffer and storage.
+    class OffsetSliceTable
+    {
+    public:
+        /// Construct an empty table.
+        OffsetSliceTable() noexcept
+            : m_offsets(nullptr), m_capacity(0), m_count(0), m_separator(0)
+        {
+        }
+
+        /// Construct an empty table for tokens of base that are separator bytes apart, using the given storage.
+        OffsetSliceTable(const StringSlice& base, StringSlice::size_type separator, uint32_t* offsets,
+            size_t capacity) noexcept
+            : m_base(base.data(), base.size()), m_offsets(offsets), m_capacity(offsets ? capacity : 0), m_count(0),
+            m_separator(separator)
+        {
+        }
+
+        /// @see OffsetSliceTable(const StringSlice&, StringSlice::size_type, uint32_t*, size_t).
+        template<size_t _Size>
+        OffsetSliceTable(const StringSlice& base, StringSlice::size_type separator, uint32_t(&offsets)[_Size])
+            noexcept
+            : OffsetSliceTable(base, separator, offsets, _Size)
+        {
+        }
+
+        /// Append a token. Returns false if the table is full, if the token is not inside the base buffer, or if
+        /// it does not start right after the previous token and separator.
+        bool append(const StringSlice& token) noexcept
+        {
+            uint64_t offset;
+            if (m_count + 2 > m_capacity || !detail::slice_offset(m_base, token, offset))
+            {
+                return false;
+            }
+
+            uint64_t next = offset + token.size() + m_separator;
+            if ((m_count > 0 && offset != m_offsets[m_count]) || next > 0xFFFFFFFFull)
+            {
+                return false;
+            }
+
+            m_offsets[m_count] = (uint32_t)offset;
+            m_offsets[++m_count] = (uint32_t)next;
+            return true;
+        }
+
+        /// Append every token in [first, last). Stops and returns false at the first token that cannot be added;
+        /// the tokens before it stay in the table.
+        template<typename Iterator>
+        bool append(Iterator first, Iterator last) noexcept
+        {
+            for (; first != last; ++first)
+            {
+                if (!append(*first))
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        /// Append each field of text split on delimiter. n delimiters give n + 1 fields, including empty ones.
+        /// The separator size must be 1. Stops and returns false at the first field that cannot be added.
+        bool append_split(const StringSlice& text, char delimiter) noexcept
+        {
+            return detail::append_split(*this, text, delimiter);
+        }
+
+        /// Remove all tokens.
+        void clear() noexcept { m_count = 0; }
+
+        /// Returns the number of tokens.
+        size_t size() const noexcept { return m_count; }
+
+        /// Returns the maximum number of tokens.
+        size_t capacity() const noexcept { return m_capacity > 0 ? m_capacity - 1 : 0; }
+
+        /// Get the token at the given index without range checking.
+        StringSlice operator[](size_t i) const noexcept
+        {
+            return StringSlice(m_base.data() + m_offsets[i], m_offsets[i + 1] - m_offsets[i] - m_separator);
+        }
+
+    private:
+        StringSlice64 m_base;
+        uint32_t* m_offsets;
+        size_t m_capacity;
+        size_t m_count;
+        StringSlice::size_type m_separator;
+    };
+}
+
+#endif // _SCOTTZ0R_SLICE_TABLE_INCLUDE_GUARD
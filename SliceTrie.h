@@ -0,0 +1,769 @@
+/// @file
+/// Defines the SliceTrie object.
+#ifndef _SCOTTZ0R_SLICE_TRIE_INCLUDE_GUARD
+#define _SCOTTZ0R_SLICE_TRIE_INCLUDE_GUARD
+
+#include <limits.h>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "StringSlice.h"
+#include "SliceArena.h"
+
+namespace scottz0r
+{
+    /// Map from strings to values stored as an adaptive radix tree (ART). Inner nodes grow from 4 to 16, 48 and
+    /// 256 children as needed, so sparse levels stay small and dense levels are one array index. Runs of bytes
+    /// with only one child are stored as a prefix on the node below (path compression), and a key with no other
+    /// keys below a node is stored as a leaf directly, so the tree depth is the number of places where keys
+    /// branch rather than the key size.
+    ///
+    /// Besides exact lookups, the trie answers longest_prefix_match, which finds the longest key that is a prefix
+    /// of a string (routing on URL paths or topic names), and visits the keys under a prefix in operator< order.
+    ///
+    /// Keys are copied and nodes are allocated from a SliceArena. Values must be trivially copyable, because the
+    /// arena never runs destructors. Once all keys are added, freeze copies the trie into a compact read only
+    /// layout. This class does not throw exceptions.
+    template<typename V>
+    class SliceTrie
+    {
+        static_assert(std::is_trivially_copyable<V>::value, "Trie values must be trivially copyable");
+
+    public:
+        using size_type = StringSlice::size_type;
+
+        /// Construct an empty trie without an arena. Inserts fail until a trie with an arena is assigned.
+        SliceTrie() noexcept
+            : m_arena(nullptr), m_root(nullptr), m_count(0), m_frozen(false)
+        {
+        }
+
+        /// Construct an empty trie that allocates from the given arena.
+        explicit SliceTrie(SliceArena& arena) noexcept
+            : m_arena(&arena), m_root(nullptr), m_count(0), m_frozen(false)
+        {
+        }
+
+        /// Returns the number of keys.
+        size_t size() const noexcept { return m_count; }
+
+        /// Returns true if the trie has no keys.
+        bool empty() const noexcept { return m_count == 0; }
+
+        /// Returns true if the trie was frozen and can no longer be changed.
+        bool frozen() const noexcept { return m_frozen; }
+
+        /// Add a key, or replace its value if it is already in the trie. Returns false if the trie has no arena,
+        /// is frozen, or the arena is too small, in which case the trie is unchanged and the arena is returned to
+        /// its previous mark.
+        bool insert(const StringSlice& key, const V& value) noexcept
+        {
+            if (!m_arena || m_frozen)
+            {
+                return false;
+            }
+
+            size_t start_mark = m_arena->mark();
+            if (!insert_key(key, value))
+            {
+                m_arena->release(start_mark);
+                return false;
+            }
+
+            return true;
+        }
+
+        /// Get the value of a key. Returns nullptr if the key is not in the trie.
+        const V* find(const StringSlice& key) const noexcept
+        {
+            const Node* node = m_root;
+            size_type depth = 0;
+            while (node)
+            {
+                if (node->type == leaf_type)
+                {
+                    if (node->prefix_size != key.size() ||
+                        !same_bytes(node->prefix + depth, key.data() + depth, key.size() - depth))
+                    {
+                        return nullptr;
+                    }
+
+                    return &static_cast<const Leaf*>(node)->value;
+                }
+
+                if (key.size() - depth < node->prefix_size ||
+                    !same_bytes(node->prefix, key.data() + depth, node->prefix_size))
+                {
+                    return nullptr;
+                }
+
+                depth += node->prefix_size;
+                if (depth == key.size())
+                {
+                    return node->terminal ? &node->terminal->value : nullptr;
+                }
+
+                Node* const* child = child_slot(node, label(key[depth++]));
+                node = child ? *child : nullptr;
+            }
+
+            return nullptr;
+        }
+
+        /// @see find(const StringSlice&) const.
+        V* find(const StringSlice& key) noexcept
+        {
+            return const_cast<V*>(static_cast<const SliceTrie*>(this)->find(key));
+        }
+
+        /// Get the value of the longest key that is a prefix of the given string, including the whole string.
+        /// Returns nullptr if there is none. If match_size is given, it receives the size of the matching key.
+        const V* longest_prefix_match(const StringSlice& str, size_type* match_size = nullptr) const noexcept
+        {
+            const Leaf* best = nullptr;
+            const Node* node = m_root;
+            size_type depth = 0;
+            while (node)
+            {
+                if (node->type == leaf_type)
+                {
+                    if (node->prefix_size <= str.size() &&
+                        same_bytes(node->prefix + depth, str.data() + depth, node->prefix_size - depth))
+                    {
+                        best = static_cast<const Leaf*>(node);
+                    }
+
+                    break;
+                }
+
+                if (str.size() - depth < node->prefix_size ||
+                    !same_bytes(node->prefix, str.data() + depth, node->prefix_size))
+                {
+                    break;
+                }
+
+                depth += node->prefix_size;
+                best = node->terminal ? node->terminal : best;
+                if (depth == str.size())
+                {
+                    break;
+                }
+
+                Node* const* child = child_slot(node, label(str[depth++]));
+                node = child ? *child : nullptr;
+            }
+
+            if (best && match_size)
+            {
+                *match_size = best->prefix_size;
+            }
+
+            return best ? &best->value : nullptr;
+        }
+
+        /// Call fn(const StringSlice& key, const V& value) for every key in operator< order. The key slices point
+        /// into the trie.
+        template<typename Fn>
+        void for_each(Fn&& fn) const noexcept
+        {
+            if (m_root)
+            {
+                visit(m_root, fn);
+            }
+        }
+
+        /// Call fn(const StringSlice& key, const V& value) for every key that starts with prefix, in operator<
+        /// order. The key slices point into the trie.
+        template<typename Fn>
+        void for_each_prefix(const StringSlice& prefix, Fn&& fn) const noexcept
+        {
+            const Node* node = m_root;
+            size_type depth = 0;
+            while (node)
+            {
+                if (node->type == leaf_type)
+                {
+                    if (node->prefix_size >= prefix.size() &&
+                        same_bytes(node->prefix + depth, prefix.data() + depth, prefix.size() - depth))
+                    {
+                        visit(node, fn);
+                    }
+
+                    return;
+                }
+
+                // Every key below the node starts with its prefix, so stop once the search prefix runs out.
+                size_type rest = prefix.size() - depth;
+                size_type n = rest < node->prefix_size ? rest : node->prefix_size;
+                if (!same_bytes(node->prefix, prefix.data() + depth, n))
+                {
+                    return;
+                }
+
+                if (rest <= node->prefix_size)
+                {
+                    visit(node, fn);
+                    return;
+                }
+
+                depth += node->prefix_size;
+                Node* const* child = child_slot(node, label(prefix[depth++]));
+                node = child ? *child : nullptr;
+            }
+        }
+
+        /// Copy the trie into the given arena in depth first order, with each node's prefix bytes and each leaf's
+        /// key stored right after it, so a lookup reads a few nearby cache lines. The frozen trie uses no memory
+        /// from the arena it was built in, which can then be reset. After freezing, insert fails, but values can
+        /// still be changed through find. Returns false if the arena is too small, in which case the
+        /// trie is unchanged and the arena is returned to its previous mark.
+        bool freeze(SliceArena& arena) noexcept
+        {
+            size_t start_mark = arena.mark();
+            Node* root = m_root ? copy_node(m_root, arena) : nullptr;
+            if (m_root && !root)
+            {
+                arena.release(start_mark);
+                return false;
+            }
+
+            m_root = root;
+            m_arena = nullptr;
+            m_frozen = true;
+            return true;
+        }
+
+    private:
+        enum : uint8_t
+        {
+            leaf_type,
+            node4_type,
+            node16_type,
+            node48_type,
+            node256_type,
+        };
+
+        struct Leaf;
+
+        /// Common header. For inner nodes, prefix is the compressed path below the parent's child label. For
+        /// leaves, prefix is the whole key.
+        struct Node
+        {
+            uint8_t type;
+            uint16_t count;
+            size_type prefix_size;
+            const char* prefix;
+            Leaf* terminal;
+        };
+
+        struct Leaf : Node
+        {
+            V value;
+        };
+
+        struct Node4 : Node
+        {
+            uint8_t labels[4];
+            Node* children[4];
+        };
+
+        struct Node16 : Node
+        {
+            uint8_t labels[16];
+            Node* children[16];
+        };
+
+        struct Node48 : Node
+        {
+            uint8_t index[256];
+            Node* children[48];
+        };
+
+        struct Node256 : Node
+        {
+            Node* children[256];
+        };
+
+        /// Child label of a character, ordered the same way as StringSlice::compare orders char values.
+        static uint8_t label(char c) noexcept
+        {
+            return (uint8_t)((unsigned char)c ^ (CHAR_MIN < 0 ? 0x80u : 0u));
+        }
+
+        static bool same_bytes(const char* a, const char* b, size_type size) noexcept
+        {
+            return size == 0 || memcmp(a, b, size) == 0;
+        }
+
+        /// Find a label in a sorted Node16 label list. Returns the index, or -1.
+        static int find_label16(const uint8_t* labels, unsigned int count, uint8_t b) noexcept
+        {
+#if defined(__SSE2__)
+            __m128i eq = _mm_cmpeq_epi8(_mm_set1_epi8((char)b), _mm_loadu_si128((const __m128i*)labels));
+            unsigned int mask = (unsigned int)_mm_movemask_epi8(eq) & ((1u << count) - 1);
+            return mask ? (int)bits::ctz64(mask) : -1;
+#else
+            for (unsigned int i = 0; i < count && labels[i] <= b; ++i)
+            {
+                if (labels[i] == b)
+                {
+                    return (int)i;
+                }
+            }
+
+            return -1;
+#endif
+        }
+
+        /// Get the child slot for a label. Returns nullptr if there is no child.
+        static Node* const* child_slot(const Node* node, uint8_t b) noexcept
+        {
+            switch (node->type)
+            {
+            case node4_type:
+            {
+                const Node4* n = static_cast<const Node4*>(node);
+                for (unsigned int i = 0; i < n->count; ++i)
+                {
+                    if (n->labels[i] == b)
+                    {
+                        return &n->children[i];
+                    }
+                }
+
+                return nullptr;
+            }
+            case node16_type:
+            {
+                const Node16* n = static_cast<const Node16*>(node);
+                int i = find_label16(n->labels, n->count, b);
+                return i < 0 ? nullptr : &n->children[i];
+            }
+            case node48_type:
+            {
+                const Node48* n = static_cast<const Node48*>(node);
+                return n->index[b] ? &n->children[n->index[b] - 1] : nullptr;
+            }
+            default:
+            {
+                const Node256* n = static_cast<const Node256*>(node);
+                return n->children[b] ? &n->children[b] : nullptr;
+            }
+            }
+        }
+
+        /// Get the child array of an inner node. Node256 slots may be null.
+        static Node** child_array(Node* node, unsigned int& slots) noexcept
+        {
+            switch (node->type)
+            {
+            case node4_type:
+                slots = node->count;
+                return static_cast<Node4*>(node)->children;
+            case node16_type:
+                slots = node->count;
+                return static_cast<Node16*>(node)->children;
+            case node48_type:
+                slots = node->count;
+                return static_cast<Node48*>(node)->children;
+            default:
+                slots = 256;
+                return static_cast<Node256*>(node)->children;
+            }
+        }
+
+        static bool is_full(const Node* node) noexcept
+        {
+            return (node->type == node4_type && node->count == 4) || (node->type == node16_type && node->count == 16) ||
+                (node->type == node48_type && node->count == 48);
+        }
+
+        static void insert_sorted(uint8_t* labels, Node** children, unsigned int count, uint8_t b, Node* child)
+            noexcept
+        {
+            unsigned int i = count;
+            for (; i > 0 && labels[i - 1] > b; --i)
+            {
+                labels[i] = labels[i - 1];
+                children[i] = children[i - 1];
+            }
+
+            labels[i] = b;
+            children[i] = child;
+        }
+
+        /// Add a child for a label that is not in the node. The node must not be full.
+        static void add_child(Node* node, uint8_t b, Node* child) noexcept
+        {
+            switch (node->type)
+            {
+            case node4_type:
+                insert_sorted(static_cast<Node4*>(node)->labels, static_cast<Node4*>(node)->children, node->count, b,
+                    child);
+                break;
+            case node16_type:
+                insert_sorted(static_cast<Node16*>(node)->labels, static_cast<Node16*>(node)->children, node->count,
+                    b, child);
+                break;
+            case node48_type:
+                static_cast<Node48*>(node)->index[b] = (uint8_t)(node->count + 1);
+                static_cast<Node48*>(node)->children[node->count] = child;
+                break;
+            default:
+                static_cast<Node256*>(node)->children[b] = child;
+                break;
+            }
+
+            ++node->count;
+        }
+
+        /// Attach a leaf to a node whose path is depth bytes long.
+        static void attach(Node* node, Leaf* leaf, size_type depth) noexcept
+        {
+            if (leaf->prefix_size == depth)
+            {
+                node->terminal = leaf;
+            }
+            else
+            {
+                add_child(node, label(leaf->prefix[depth]), leaf);
+            }
+        }
+
+        /// Visit a subtree in order: the key that ends at a node sorts before the keys below it.
+        template<typename Fn>
+        static void visit(const Node* node, Fn& fn) noexcept
+        {
+            if (node->type == leaf_type)
+            {
+                const Leaf* leaf = static_cast<const Leaf*>(node);
+                fn(StringSlice(leaf->prefix, leaf->prefix_size), leaf->value);
+                return;
+            }
+
+            if (node->terminal)
+            {
+                visit(node->terminal, fn);
+            }
+
+            if (node->type == node48_type)
+            {
+                const Node48* n = static_cast<const Node48*>(node);
+                for (unsigned int b = 0; b < 256; ++b)
+                {
+                    if (n->index[b])
+                    {
+                        visit(n->children[n->index[b] - 1], fn);
+                    }
+                }
+
+                return;
+            }
+
+            // Node4 and Node16 keep their labels sorted, and Node256 is indexed by label.
+            unsigned int slots;
+            Node* const* children = child_array(const_cast<Node*>(node), slots);
+            for (unsigned int i = 0; i < slots; ++i)
+            {
+                if (children[i])
+                {
+                    visit(children[i], fn);
+                }
+            }
+        }
+
+        template<typename T>
+        T* new_node(uint8_t type) noexcept
+        {
+            T* n = m_arena->template allocate<T>(1);
+            if (n)
+            {
+                memset((void*)n, 0, sizeof(T));
+                n->type = type;
+            }
+
+            return n;
+        }
+
+        Leaf* new_leaf(const StringSlice& key, const V& value) noexcept
+        {
+            char* bytes = m_arena->template allocate<char>(key.size());
+            Leaf* leaf = new_node<Leaf>(leaf_type);
+            if (!bytes || !leaf)
+            {
+                return nullptr;
+            }
+
+            memcpy(bytes, key.data(), key.size());
+            leaf->prefix = bytes;
+            leaf->prefix_size = key.size();
+            memcpy((void*)&leaf->value, (const void*)&value, sizeof(V));
+            return leaf;
+        }
+
+        /// Make the next larger node type with the same header and children.
+        Node* grow(const Node* node) noexcept
+        {
+            switch (node->type)
+            {
+            case node4_type:
+            {
+                const Node4* n = static_cast<const Node4*>(node);
+                Node16* g = new_node<Node16>(node16_type);
+                if (g)
+                {
+                    *static_cast<Node*>(g) = *node;
+                    g->type = node16_type;
+                    memcpy(g->labels, n->labels, sizeof(n->labels));
+                    memcpy(g->children, n->children, sizeof(n->children));
+                }
+
+                return g;
+            }
+            case node16_type:
+            {
+                const Node16* n = static_cast<const Node16*>(node);
+                Node48* g = new_node<Node48>(node48_type);
+                if (g)
+                {
+                    *static_cast<Node*>(g) = *node;
+                    g->type = node48_type;
+                    for (unsigned int i = 0; i < n->count; ++i)
+                    {
+                        g->index[n->labels[i]] = (uint8_t)(i + 1);
+                        g->children[i] = n->children[i];
+                    }
+                }
+
+                return g;
+            }
+            default:
+            {
+                const Node48* n = static_cast<const Node48*>(node);
+                Node256* g = new_node<Node256>(node256_type);
+                if (g)
+                {
+                    *static_cast<Node*>(g) = *node;
+                    g->type = node256_type;
+                    for (unsigned int b = 0; b < 256; ++b)
+                    {
+                        if (n->index[b])
+                        {
+                            g->children[b] = n->children[n->index[b] - 1];
+                        }
+                    }
+                }
+
+                return g;
+            }
+            }
+        }
+
+        /// Insert without cleaning up on failure. Nothing is changed until every allocation has succeeded.
+        bool insert_key(const StringSlice& key, const V& value) noexcept
+        {
+            Node** ref = &m_root;
+            size_type depth = 0;
+            for (;;)
+            {
+                Node* node = *ref;
+                if (!node)
+                {
+                    Leaf* leaf = new_leaf(key, value);
+                    if (!leaf)
+                    {
+                        return false;
+                    }
+
+                    *ref = leaf;
+                    ++m_count;
+                    return true;
+                }
+
+                if (node->type == leaf_type)
+                {
+                    Leaf* existing = static_cast<Leaf*>(node);
+                    size_type common = depth;
+                    while (common < existing->prefix_size && common < key.size() && existing->prefix[common] == key[common])
+                    {
+                        ++common;
+                    }
+
+                    if (common == existing->prefix_size && common == key.size())
+                    {
+                        existing->value = value;
+                        return true;
+                    }
+
+                    // Replace the leaf with a node that branches where the two keys differ.
+                    Leaf* leaf = new_leaf(key, value);
+                    Node4* split = new_node<Node4>(node4_type);
+                    if (!leaf || !split)
+                    {
+                        return false;
+                    }
+
+                    split->prefix = leaf->prefix + depth;
+                    split->prefix_size = common - depth;
+                    attach(split, existing, common);
+                    attach(split, leaf, common);
+                    *ref = split;
+                    ++m_count;
+                    return true;
+                }
+
+                size_type matched = 0;
+                while (matched < node->prefix_size && depth + matched < key.size() &&
+                    node->prefix[matched] == key[depth + matched])
+                {
+                    ++matched;
+                }
+
+                if (matched < node->prefix_size)
+                {
+                    // The key leaves the compressed path, so split the path where it does.
+                    Leaf* leaf = new_leaf(key, value);
+                    Node4* split = new_node<Node4>(node4_type);
+                    if (!leaf || !split)
+                    {
+                        return false;
+                    }
+
+                    split->prefix = node->prefix;
+                    split->prefix_size = matched;
+                    add_child(split, label(node->prefix[matched]), node);
+                    node->prefix += matched + 1;
+                    node->prefix_size -= matched + 1;
+                    attach(split, leaf, depth + matched);
+                    *ref = split;
+                    ++m_count;
+                    return true;
+                }
+
+                depth += node->prefix_size;
+                if (depth == key.size())
+                {
+                    if (node->terminal)
+                    {
+                        node->terminal->value = value;
+                        return true;
+                    }
+
+                    Leaf* leaf = new_leaf(key, value);
+                    if (!leaf)
+                    {
+                        return false;
+                    }
+
+                    node->terminal = leaf;
+                    ++m_count;
+                    return true;
+                }
+
+                uint8_t b = label(key[depth]);
+                Node* const* child = child_slot(node, b);
+                if (child)
+                {
+                    ref = const_cast<Node**>(child);
+                    ++depth;
+                    continue;
+                }
+
+                Leaf* leaf = new_leaf(key, value);
+                if (!leaf)
+                {
+                    return false;
+                }
+
+                if (is_full(node))
+                {
+                    node = grow(node);
+                    if (!node)
+                    {
+                        return false;
+                    }
+
+                    *ref = node;
+                }
+
+                add_child(node, b, leaf);
+                ++m_count;
+                return true;
+            }
+        }
+
+        template<typename T>
+        static Node* copy_as(const Node* node, SliceArena& arena) noexcept
+        {
+            T* copy = arena.allocate<T>(1);
+            if (copy)
+            {
+                memcpy((void*)copy, (const void*)node, sizeof(T));
+            }
+
+            return copy;
+        }
+
+        /// Copy a subtree for freeze. Returns nullptr if the arena is too small.
+        static Node* copy_node(const Node* node, SliceArena& arena) noexcept
+        {
+            Node* copy;
+            switch (node->type)
+            {
+            case leaf_type: copy = copy_as<Leaf>(node, arena); break;
+            case node4_type: copy = copy_as<Node4>(node, arena); break;
+            case node16_type: copy = copy_as<Node16>(node, arena); break;
+            case node48_type: copy = copy_as<Node48>(node, arena); break;
+            default: copy = copy_as<Node256>(node, arena); break;
+            }
+
+            char* prefix = arena.allocate<char>(node->prefix_size);
+            if (!copy || !prefix)
+            {
+                return nullptr;
+            }
+
+            memcpy(prefix, node->prefix, node->prefix_size);
+            copy->prefix = prefix;
+            if (copy->type == leaf_type)
+            {
+                return copy;
+            }
+
+            if (copy->terminal)
+            {
+                copy->terminal = static_cast<Leaf*>(copy_node(copy->terminal, arena));
+                if (!copy->terminal)
+                {
+                    return nullptr;
+                }
+            }
+
+            unsigned int slots;
+            Node** children = child_array(copy, slots);
+            for (unsigned int i = 0; i < slots; ++i)
+            {
+                if (children[i])
+                {
+                    children[i] = copy_node(children[i], arena);
+                    if (!children[i])
+                    {
+                        return nullptr;
+                    }
+                }
+            }
+
+            return copy;
+        }
+
+        SliceArena* m_arena;
+        Node* m_root;
+        size_t m_count;
+        bool m_frozen;
+    };
+}
+
+#endif // _SCOTTZ0R_SLICE_TRIE_INCLUDE_GUARD
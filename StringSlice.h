@@ -1,47 +1,64 @@
 /// @file
-/// Defines the StringSlice object.
+/// Defines the BasicStringSlice template and the StringSlice type.
 #ifndef _SCOTTZ0R_STRING_SLICE_INCLUDE_GUARD
 #define _SCOTTZ0R_STRING_SLICE_INCLUDE_GUARD
 
+#include <stddef.h>
+
+#include "SliceBits.h"
+
 namespace scottz0r
 {
-    /// Non owning slice of a string. This has the same lifetime as the m_str pointer. This class does not
-    /// throw exceptions.
-    class StringSlice
+    /// Non owning slice of a string of CharT, with lengths and positions stored as SizeT. This has the same
+    /// lifetime as the m_str pointer. This class does not throw exceptions.
+    ///
+    /// CharT may be any 1, 2 or 4 byte character type. The word-at-a-time kernels (find, count, the case
+    /// insensitive functions and hashing) work on 8, 4 or 2 characters per 64-bit word to match. SizeT may be any
+    /// unsigned integer type: uint16_t keeps slices small on small targets, and uint64_t allows slices over 4 GiB.
+    template<typename CharT, typename SizeT>
+    class BasicStringSlice
     {
+        static_assert(sizeof(CharT) == 1 || sizeof(CharT) == 2 || sizeof(CharT) == 4, "Unsupported character size");
+        static_assert(SizeT(-1) > SizeT(0), "Size type must be unsigned");
+
+        using lanes = bits::Lanes<sizeof(CharT)>;
+        static constexpr unsigned int lane_width = sizeof(CharT);
+        static constexpr unsigned int lanes_per_word = 8 / sizeof(CharT);
+
     public:
-        using size_type = unsigned int;
+        using char_type = CharT;
+        using size_type = SizeT;
         static constexpr size_type npos = (size_type)-1;
 
         /// Default construct to an empty slice.
-        StringSlice() noexcept
+        BasicStringSlice() noexcept
             : m_str(nullptr), m_size(0)
         {
         }
 
         /// Construct with a string. This will loop until a null character is found. Does not include terminating
         /// null character.
-        StringSlice(const char* str) noexcept
+        BasicStringSlice(const char_type* str) noexcept
             : m_str(str), m_size(0)
         {
-            const char* p_str = m_str;
+            const char_type* p_str = m_str;
             while (*p_str != 0)
             {
                 ++p_str;
             }
 
-            m_size = p_str - m_str;
+            m_size = (size_type)(p_str - m_str);
         }
 
         /// Construct with a string and size. Null characters will be included.
-        StringSlice(const char* str, size_type size) noexcept
+        BasicStringSlice(const char_type* str, size_type size) noexcept
             : m_str(str), m_size(size)
         {
 
         }
 
         /// Copy constructor. This slice will have the same lifetime as the other slice.
-        StringSlice(const StringSlice& other) noexcept
+        BasicStringSlice(const BasicStringSlice& other) noexcept
         {
             m_str = other.m_str;
             m_size = other.m_size;
@@ -61,7 +78,7 @@ namespace scottz0r
 
         /// Compare to another StringSlice. Returns -1 if this is less than the other slice. Returns 1 if this
         /// is greater than the other slice. Returns 0 if slices are equal.
-        int compare(const StringSlice& other) const noexcept
+        int compare(const BasicStringSlice& other) const noexcept
         {
             for (size_type i = 0; i < m_size && i < other.m_size; ++i)
             {
@@ -92,7 +109,7 @@ namespace scottz0r
 
         /// @see copy_to.
         template<size_type _Size>
-        inline size_type copy_to(char(&dst)[_Size]) const
+        inline size_type copy_to(char_type(&dst)[_Size]) const
         {
             return copy_to(dst, _Size);
         }
@@ -100,7 +117,7 @@ namespace scottz0r
         /// Copy this slice to a character buffer. This will always null terminate. Returns the number of
         /// characters copied, not including the null terminator. If the destination buffer is too small, the
         /// result will be truncated.
-        size_type copy_to(char* dst, size_type dst_size) const
+        size_type copy_to(char_type* dst, size_type dst_size) const
         {
             if (!dst || dst_size == 0)
             {
@@ -126,22 +143,50 @@ namespace scottz0r
             return i;
         }
 
+        /// Returns the number of times the given character appears in the slice.
+        size_type count(char_type c) const noexcept
+        {
+            uint64_t pattern = lanes::ones * lane(c);
+            size_type n = 0;
+
+            size_type i = 0;
+            for (; i + lanes_per_word <= m_size; i += lanes_per_word)
+            {
+                n += bits::popcount64(bits::zero_lanes_exact<lane_width>(load_word(m_str + i) ^ pattern));
+            }
+
+            for (; i < m_size; ++i)
+            {
+                n += m_str[i] == c;
+            }
+
+            return n;
+        }
+
         /// Get a pointer to the data.
-        const char* data() const noexcept { return m_str; }
+        const char_type* data() const noexcept { return m_str; }
 
         /// Returns true if the slice is empty.
         bool empty() const noexcept { return m_size == 0; }
 
         /// Find the given character in the slice. Returns the index of the character. Returns StringSlice::npos
         /// if the character is not found.
-        size_type find(char c, size_type start = 0) const noexcept
+        size_type find(char_type c, size_type start = 0) const noexcept
         {
             if (start >= m_size)
             {
                 return npos;
             }
 
-            for (size_type i = start; i < m_size; ++i)
+            // Skip a word at a time while none of its characters match.
+            uint64_t pattern = lanes::ones * lane(c);
+            size_type i = start;
+            while (i + lanes_per_word <= m_size && bits::zero_lanes<lane_width>(load_word(m_str + i) ^ pattern) == 0)
+            {
+                i += lanes_per_word;
+            }
+
+            for (; i < m_size; ++i)
             {
                 if (m_str[i] == c)
                 {
@@ -152,11 +197,183 @@ namespace scottz0r
             return npos;
         }
 
+        /// Find the given substring in the slice. Returns the index of the first match at or after start. Returns
+        /// StringSlice::npos if the substring is not found. An empty needle matches at start.
+        size_type find(const BasicStringSlice& needle, size_type start = 0) const noexcept
+        {
+            if (needle.empty())
+            {
+                return start <= m_size ? start : npos;
+            }
+
+            if (needle.m_size > m_size)
+            {
+                return npos;
+            }
+
+            size_type last = m_size - needle.m_size;
+            for (size_type i = find(needle.m_str[0], start); i != npos && i <= last; i = find(needle.m_str[0], i + 1))
+            {
+                if (BasicStringSlice(m_str + i, needle.m_size) == needle)
+                {
+                    return i;
+                }
+            }
+
+            return npos;
+        }
+
+        /// Returns a 64-bit hash of the slice contents. Slices that are equal have the same hash.
+        uint64_t hash() const noexcept
+        {
+            return hash_words(false);
+        }
+
+        /// Compare to another StringSlice, ignoring ASCII case. Return values are the same as compare.
+        int icompare(const BasicStringSlice& other) const noexcept
+        {
+            size_type min_size = m_size < other.m_size ? m_size : other.m_size;
+            size_type i = 0;
+
+            // Skip the common prefix a word at a time.
+            while (i + lanes_per_word <= min_size &&
+                bits::fold_case_lanes<lane_width>(load_word(m_str + i)) == bits::fold_case_lanes<lane_width>(load_word(other.m_str + i)))
+            {
+                i += lanes_per_word;
+            }
+
+            for (; i < min_size; ++i)
+            {
+                int diff = bits::fold_case(m_str[i]) - bits::fold_case(other.m_str[i]);
+
+                if (diff < 0)
+                {
+                    return -1;
+                }
+
+                if (diff > 0)
+                {
+                    return 1;
+                }
+            }
+
+            if (m_size < other.m_size)
+            {
+                return -1;
+            }
+            else if (m_size > other.m_size)
+            {
+                return 1;
+            }
+
+            return 0;
+        }
+
+        /// Returns true if this slice is equal to the other slice, ignoring ASCII case. Non-ASCII bytes must match
+        /// exactly.
+        bool iequals(const BasicStringSlice& other) const noexcept
+        {
+            if (other.m_size != m_size)
+            {
+                return false;
+            }
+
+            size_type i = 0;
+            for (; i + lanes_per_word <= m_size; i += lanes_per_word)
+            {
+                uint64_t a = bits::fold_case_lanes<lane_width>(load_word(m_str + i));
+                uint64_t b = bits::fold_case_lanes<lane_width>(load_word(other.m_str + i));
+
+                if (a != b)
+                {
+                    return false;
+                }
+            }
+
+            for (; i < m_size; ++i)
+            {
+                if (bits::fold_case(m_str[i]) != bits::fold_case(other.m_str[i]))
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        /// Find the given character in the slice, ignoring ASCII case. Returns the index of the character. Returns
+        /// StringSlice::npos if the character is not found.
+        size_type ifind(char_type c, size_type start = 0) const noexcept
+        {
+            if (start >= m_size)
+            {
+                return npos;
+            }
+
+            char_type lower = bits::fold_case(c);
+            uint64_t pattern = lanes::ones * lane(lower);
+
+            size_type i = start;
+            while (i + lanes_per_word <= m_size && bits::zero_lanes<lane_width>(bits::fold_case_lanes<lane_width>(load_word(m_str + i)) ^ pattern) == 0)
+            {
+                i += lanes_per_word;
+            }
+
+            for (; i < m_size; ++i)
+            {
+                if (bits::fold_case(m_str[i]) == lower)
+                {
+                    return i;
+                }
+            }
+
+            return npos;
+        }
+
+        /// Find the given substring in the slice, ignoring ASCII case. Returns the index of the first match at or
+        /// after start. Returns StringSlice::npos if the substring is not found. An empty needle matches at start.
+        size_type ifind(const BasicStringSlice& needle, size_type start = 0) const noexcept
+        {
+            if (needle.empty())
+            {
+                return start <= m_size ? start : npos;
+            }
+
+            if (needle.m_size > m_size)
+            {
+                return npos;
+            }
+
+            size_type last = m_size - needle.m_size;
+            for (size_type i = ifind(needle.m_str[0], start); i != npos && i <= last; i = ifind(needle.m_str[0], i + 1))
+            {
+                if (BasicStringSlice(m_str + i, needle.m_size).iequals(needle))
+                {
+                    return i;
+                }
+            }
+
+            return npos;
+        }
+
+        /// Returns a 64-bit hash of the slice contents with ASCII case folded. Slices that are equal with iequals
+        /// have the same hash.
+        uint64_t ihash() const noexcept
+        {
+            return hash_words(true);
+        }
+
+        /// Returns true if this slice starts with the given prefix, ignoring ASCII case.
+        bool istarts_with(const BasicStringSlice& prefix) const noexcept
+        {
+            return prefix.m_size <= m_size && BasicStringSlice(m_str, prefix.m_size).iequals(prefix);
+        }
+
         /// Returns a new slice without leading whitespace.
-        StringSlice lstrip() const noexcept
+        BasicStringSlice lstrip() const noexcept
         {
-            const char* p = m_str;
-            const char* end = m_str + m_size;
+            const char_type* p = m_str;
+            const char_type* end = m_str + m_size;
 
             while (p < end)
             {
@@ -168,14 +385,14 @@ namespace scottz0r
                 ++p;
             }
 
-            size_type new_size = end - p;
-            return StringSlice(p, new_size);
+            size_type new_size = (size_type)(end - p);
+            return BasicStringSlice(p, new_size);
         }
 
         /// Returns a new slice without trailing whitespace.
-        StringSlice rstrip() const noexcept
+        BasicStringSlice rstrip() const noexcept
         {
-            const char* p = m_str + m_size;
+            const char_type* p = m_str + m_size;
 
             while ((p--) > m_str)
             {
@@ -188,15 +405,15 @@ namespace scottz0r
             // Increment pointer because of post decrement in while loop.
             ++p;
 
-            size_type new_size = p - m_str;
-            return StringSlice(m_str, new_size);
+            size_type new_size = (size_type)(p - m_str);
+            return BasicStringSlice(m_str, new_size);
         }
 
         /// Returns the number of characters in the slice.
         size_type size() const noexcept { return m_size; }
 
         /// @brief Return a new slice with leading and trailing whitespace removed.
-        StringSlice strip() const noexcept
+        BasicStringSlice strip() const noexcept
         {
             return rstrip().lstrip();
         }
@@ -204,26 +421,26 @@ namespace scottz0r
         /// Returns a new slice that is a substring of this slice. An empty slice is returned if the starting
         /// position is out of range. If len is larger than the remaining bytes in the slice, the extra length is
         /// ignored.
-        StringSlice substr(size_type pos, size_type len = npos) const noexcept
+        BasicStringSlice substr(size_type pos, size_type len = npos) const noexcept
         {
             if (pos < m_size)
             {
                 size_type real_len = m_size - pos;
                 real_len = real_len < len ? real_len : len;
-                return StringSlice(m_str + pos, real_len);
+                return BasicStringSlice(m_str + pos, real_len);
             }
 
-            return StringSlice();
+            return BasicStringSlice();
         }
 
         /// Get the character at the given index without range checking.
-        char operator[](size_type i) const noexcept
+        char_type operator[](size_type i) const noexcept
         {
             return m_str[i];
         }
 
         /// Assignment operator. The lifetime of this slice will become the same as the other slice.
-        StringSlice& operator=(const StringSlice& other) noexcept
+        BasicStringSlice& operator=(const BasicStringSlice& other) noexcept
         {
             m_str = other.m_str;
             m_size = other.m_size;
@@ -242,7 +459,7 @@ namespace scottz0r
             return m_size == 0;
         }
 
-        bool operator==(const StringSlice& other) const noexcept
+        bool operator==(const BasicStringSlice& other) const noexcept
         {
             if (other.m_size != m_size)
             {
@@ -260,30 +477,30 @@ namespace scottz0r
             return true;
         }
 
-        bool operator!=(const StringSlice& other) const noexcept
+        bool operator!=(const BasicStringSlice& other) const noexcept
         {
             return !(*this == other);
         }
 
-        bool operator<(const StringSlice& other) const noexcept
+        bool operator<(const BasicStringSlice& other) const noexcept
         {
             int c = compare(other);
             return c < 0;
         }
 
-        bool operator<=(const StringSlice& other) const noexcept
+        bool operator<=(const BasicStringSlice& other) const noexcept
         {
             int c = compare(other);
             return c <= 0;
         }
 
-        bool operator>(const StringSlice& other) const noexcept
+        bool operator>(const BasicStringSlice& other) const noexcept
         {
             int c = compare(other);
             return c > 0;
         }
 
-        bool operator>=(const StringSlice& other) const noexcept
+        bool operator>=(const BasicStringSlice& other) const noexcept
         {
             int c = compare(other);
             return c >= 0;
@@ -291,15 +508,120 @@ namespace scottz0r
 
     private:
 
-        inline bool is_whitespace(char c) const noexcept
+        /// Hash the characters as bytes, a word at a time.
+        uint64_t hash_words(bool fold) const noexcept
+        {
+            uint64_t h = 0x9E3779B97F4A7C15ull ^ (uint64_t)m_size;
+
+            size_type i = 0;
+            for (; i + lanes_per_word <= m_size; i += lanes_per_word)
+            {
+                uint64_t w = load_word(m_str + i);
+                h = bits::hash_mix(h, fold ? bits::fold_case_lanes<lane_width>(w) : w);
+            }
+
+            if (i < m_size)
+            {
+                uint64_t w = bits::load_partial_u64((const char*)(m_str + i), (unsigned int)((m_size - i) * lane_width));
+                h = bits::hash_mix(h, fold ? bits::fold_case_lanes<lane_width>(w) : w);
+            }
+
+            return bits::hash_finish(h);
+        }
+
+        /// Unaligned load of one 64-bit word of characters.
+        static uint64_t load_word(const char_type* p) noexcept
+        {
+            return bits::load_u64((const char*)p);
+        }
+
+        /// Zero extend a character to a lane value.
+        static uint64_t lane(char_type c) noexcept
+        {
+            return (typename lanes::lane_type)c;
+        }
+
+        inline bool is_whitespace(char_type c) const noexcept
         {
             return c == '\r' || c == '\n' || c == '\t' || c == ' ';
         }
 
-        const char* m_str;
+        const char_type* m_str;
         size_type m_size;
     };
 
+    /// Slice of char with 32-bit sizes. This is the slice type used by the rest of the library.
+    using StringSlice = BasicStringSlice<char, unsigned int>;
+
+    /// Slice of char with 64-bit sizes, for buffers over 4 GiB such as large memory mapped files.
+    using StringSlice64 = BasicStringSlice<char, uint64_t>;
+
+    /// Slice of char with 16-bit sizes, for small targets where slice size matters.
+    using SmallStringSlice = BasicStringSlice<char, uint16_t>;
+
+    /// Slice of raw bytes.
+    using ByteSlice = BasicStringSlice<uint8_t, unsigned int>;
+
+#if defined(__cpp_char8_t)
+    /// Slice of UTF-8 code units.
+    using U8StringSlice = BasicStringSlice<char8_t, unsigned int>;
+#endif
+
+    /// Slice of UTF-16 code units.
+    using U16StringSlice = BasicStringSlice<char16_t, unsigned int>;
+
+    /// Hash function object for StringSlice keys in hash containers. Transparent, so lookups can use anything that
+    /// converts to a StringSlice.
+    struct StringSliceHash
+    {
+        using is_transparent = void;
+
+        size_t operator()(const StringSlice& slice) const noexcept
+        {
+            return (size_t)slice.hash();
+        }
+
+        template<typename CharT, typename SizeT>
+        size_t operator()(const BasicStringSlice<CharT, SizeT>& slice) const noexcept
+        {
+            return (size_t)slice.hash();
+        }
+    };
+
+    /// Case insensitive hash function object. Use with StringSliceIEqual.
+    struct StringSliceIHash
+    {
+        using is_transparent = void;
+
+        size_t operator()(const StringSlice& slice) const noexcept
+        {
+            return (size_t)slice.ihash();
+        }
+
+        template<typename CharT, typename SizeT>
+        size_t operator()(const BasicStringSlice<CharT, SizeT>& slice) const noexcept
+        {
+            return (size_t)slice.ihash();
+        }
+    };
+
+    /// Case insensitive equality function object. Use with StringSliceIHash.
+    struct StringSliceIEqual
+    {
+        using is_transparent = void;
+
+        bool operator()(const StringSlice& a, const StringSlice& b) const noexcept
+        {
+            return a.iequals(b);
+        }
+
+        template<typename CharT, typename SizeT>
+        bool operator()(const BasicStringSlice<CharT, SizeT>& a, const BasicStringSlice<CharT, SizeT>& b) const noexcept
+        {
+            return a.iequals(b);
+        }
+    };
+
     /// Converts a character buffer to a slice using a C++ array size template. This assumes the character buffer
     /// is null terminated at the last index. The null terminator at the last index will not be included in the slice.
     // Null terminators not at the end of the array will be included in the slice.
@@ -313,22 +635,36 @@ namespace scottz0r
         return StringSlice(str, Size - 1);
     }
 
+    /// @see to_slice(const char(&)[Size]). Converts a buffer of any other character type (ex: `to_slice(u"xyz")`).
+    template<typename CharT, unsigned int Size>
+    constexpr BasicStringSlice<CharT, unsigned int> to_slice(const CharT(&str)[Size]) noexcept
+    {
+        static_assert(Size != 0, "Buffer size cannot be 0");
+
+        return BasicStringSlice<CharT, unsigned int>(str, Size - 1);
+    }
+
     /// Get a line from a slice. Includes the newline in the returned slice. If no newlines are found, the entire
     /// slice is returned.
-    inline StringSlice get_line(const StringSlice& slice) noexcept
+    template<typename CharT, typename SizeT>
+    BasicStringSlice<CharT, SizeT> get_line(const BasicStringSlice<CharT, SizeT>& slice) noexcept
     {
-        for (StringSlice::size_type i = 0; i < slice.size(); ++i)
+        SizeT i = slice.find((CharT)'\n');
+        if (i != BasicStringSlice<CharT, SizeT>::npos)
         {
-            if (slice[i] == '\n')
-            {
-                // Add one to size to pick up newline character.
-                return StringSlice(slice.data(), i + 1);
-            }
+            // Add one to size to pick up newline character.
+            return BasicStringSlice<CharT, SizeT>(slice.data(), i + 1);
         }
 
         // Return entire slice if a newline was not found.
         return slice;
     }
+
+    /// @see get_line(const BasicStringSlice<CharT, SizeT>&). Accepts anything that converts to a StringSlice.
+    inline StringSlice get_line(const StringSlice& slice) noexcept
+    {
+        return get_line<char, unsigned int>(slice);
+    }
 }
 
 #endif // _SCOTTZ0R_STRING_SLICE_INCLUDE_GUARD
@@ -0,0 +1,443 @@
+/// @file
+/// Defines the SuffixArray object.
+#ifndef _SCOTTZ0R_SUFFIX_ARRAY_INCLUDE_GUARD
+#define _SCOTTZ0R_SUFFIX_ARRAY_INCLUDE_GUARD
+
+#include "StringSlice.h"
+#include "SliceArena.h"
+
+namespace scottz0r
+{
+    namespace detail
+    {
+        /// Marks an empty suffix array slot during construction.
+        static constexpr uint32_t sais_empty = 0xFFFFFFFFu;
+
+        /// Characters of the text shifted up by one, followed by a 0 sentinel that is smaller than every character.
+        struct SaisText
+        {
+            const unsigned char* text;
+            uint32_t size;
+
+            uint32_t operator()(uint32_t i) const noexcept { return i < size ? text[i] + 1u : 0u; }
+        };
+
+        /// Characters of a reduced string, which already ends with a unique smallest name.
+        struct SaisNames
+        {
+            const uint32_t* names;
+
+            uint32_t operator()(uint32_t i) const noexcept { return names[i]; }
+        };
+
+        /// Set each bucket to its start, or to its end if end is true.
+        template<typename Str>
+        void sais_buckets(const Str& s, uint32_t* bkt, uint32_t n, uint32_t k, bool end) noexcept
+        {
+            memset(bkt, 0, (k + 1) * sizeof(uint32_t));
+            for (uint32_t i = 0; i < n; ++i)
+            {
+                ++bkt[s(i)];
+            }
+
+            uint32_t sum = 0;
+            for (uint32_t c = 0; c <= k; ++c)
+            {
+                sum += bkt[c];
+                bkt[c] = end ? sum : sum - bkt[c];
+            }
+        }
+
+        /// Induce the order of the L-type suffixes from the sorted suffixes already in sa, then the S-type ones.
+        template<typename Str>
+        void sais_induce(const Str& s, const uint8_t* stype, uint32_t* sa, uint32_t* bkt, uint32_t n, uint32_t k)
+            noexcept
+        {
+            sais_buckets(s, bkt, n, k, false);
+            for (uint32_t i = 0; i < n; ++i)
+            {
+                if (sa[i] != sais_empty && sa[i] > 0 && !stype[sa[i] - 1])
+                {
+                    sa[bkt[s(sa[i] - 1)]++] = sa[i] - 1;
+                }
+            }
+
+            sais_buckets(s, bkt, n, k, true);
+            for (uint32_t i = n; i-- > 0;)
+            {
+                if (sa[i] != sais_empty && sa[i] > 0 && stype[sa[i] - 1])
+                {
+                    sa[--bkt[s(sa[i] - 1)]] = sa[i] - 1;
+                }
+            }
+        }
+
+        /// Suffix array by induced sorting (SA-IS, Nong, Zhang and Chan). s has n characters in [0, k], and the
+        /// last one is a unique 0. Sorts the leftmost S-type (LMS) substrings by inducing, names them, sorts the
+        /// string of names recursively if the names are not unique, and induces the full order from the sorted
+        /// LMS suffixes. Scratch is n bytes plus k + 1 words per level from the arena, released before returning.
+        template<typename Str>
+        bool sais(const Str& s, uint32_t* sa, uint32_t n, uint32_t k, SliceArena& arena) noexcept
+        {
+            size_t start_mark = arena.mark();
+            uint8_t* stype = arena.allocate<uint8_t>(n);
+            uint32_t* bkt = arena.allocate<uint32_t>((size_t)k + 1);
+            if (!stype || !bkt)
+            {
+                arena.release(start_mark);
+                return false;
+            }
+
+            stype[n - 1] = 1;
+            for (uint32_t i = n - 1; i-- > 0;)
+            {
+                stype[i] = s(i) < s(i + 1) || (s(i) == s(i + 1) && stype[i + 1]);
+            }
+
+            auto is_lms = [&](uint32_t i) { return i > 0 && i != sais_empty && stype[i] && !stype[i - 1]; };
+
+            // Stage 1: sort the LMS substrings.
+            sais_buckets(s, bkt, n, k, true);
+            for (uint32_t i = 0; i < n; ++i)
+            {
+                sa[i] = sais_empty;
+            }
+
+            for (uint32_t i = 1; i < n; ++i)
+            {
+                if (is_lms(i))
+                {
+                    sa[--bkt[s(i)]] = i;
+                }
+            }
+
+            sais_induce(s, stype, sa, bkt, n, k);
+
+            uint32_t n1 = 0;
+            for (uint32_t i = 0; i < n; ++i)
+            {
+                if (is_lms(sa[i]))
+                {
+                    sa[n1++] = sa[i];
+                }
+            }
+
+            // Name the LMS substrings in sorted order; equal substrings get the same name. No two LMS positions
+            // are adjacent, so pos / 2 gives each a distinct slot in the upper half.
+            for (uint32_t i = n1; i < n; ++i)
+            {
+                sa[i] = sais_empty;
+            }
+
+            uint32_t name = 0;
+            uint32_t prev = sais_empty;
+            for (uint32_t i = 0; i < n1; ++i)
+            {
+                uint32_t pos = sa[i];
+                bool diff = prev == sais_empty;
+                for (uint32_t d = 0; !diff && d < n; ++d)
+                {
+                    if (s(pos + d) != s(prev + d) || stype[pos + d] != stype[prev + d])
+                    {
+                        diff = true;
+                    }
+                    else if (d > 0 && (is_lms(pos + d) || is_lms(prev + d)))
+                    {
+                        break;
+                    }
+                }
+
+                if (diff)
+                {
+                    ++name;
+                    prev = pos;
+                }
+
+                sa[n1 + pos / 2] = name - 1;
+            }
+
+            for (uint32_t i = n, j = n; i-- > n1;)
+            {
+                if (sa[i] != sais_empty)
+                {
+                    sa[--j] = sa[i];
+                }
+            }
+
+            // Stage 2: order the LMS suffixes by sorting the string of names.
+            uint32_t* s1 = sa + n - n1;
+            if (name < n1)
+            {
+                if (!sais(SaisNames{ s1 }, sa, n1, name - 1, arena))
+                {
+                    arena.release(start_mark);
+                    return false;
+                }
+            }
+            else
+            {
+                for (uint32_t i = 0; i < n1; ++i)
+                {
+                    sa[s1[i]] = i;
+                }
+            }
+
+            // Stage 3: put the sorted LMS suffixes at the ends of their buckets and induce the rest.
+            for (uint32_t i = 1, j = 0; i < n; ++i)
+            {
+                if (is_lms(i))
+                {
+                    s1[j++] = i;
+                }
+            }
+
+            for (uint32_t i = 0; i < n1; ++i)
+            {
+                sa[i] = s1[sa[i]];
+            }
+
+            for (uint32_t i = n1; i < n; ++i)
+            {
+                sa[i] = sais_empty;
+            }
+
+            sais_buckets(s, bkt, n, k, true);
+            for (uint32_t i = n1; i-- > 0;)
+            {
+                uint32_t j = sa[i];
+                sa[i] = sais_empty;
+                sa[--bkt[s(j)]] = j;
+            }
+
+            sais_induce(s, stype, sa, bkt, n, k);
+            arena.release(start_mark);
+            return true;
+        }
+    }
+
+    /// Suffix array of one large slice, for repeated substring queries. Positions of all suffixes of the text
+    /// are kept in sorted order, so the suffixes that start with a pattern form one range found by binary
+    /// search in O(m log n) for a pattern of size m, instead of scanning the text. The optional LCP array holds
+    /// the common prefix size of neighboring suffixes, which gives the longest repeated substring.
+    ///
+    /// Built in linear time with SA-IS. Suffixes are ordered by unsigned byte value, like memcmp. The text is
+    /// not copied, and must stay valid while the array is used, and be less than 4 GiB.
+    ///
+    /// All memory comes from a SliceArena: 4 bytes per text byte for the array and 4 more for the LCP array.
+    /// Building needs up to 4 more bytes per text byte plus 1 KiB of scratch, which is returned to the arena
+    /// afterwards. This class does not throw exceptions.
+    class SuffixArray
+    {
+    public:
+        using size_type = StringSlice::size_type;
+
+        /// Construct an empty suffix array.
+        SuffixArray() noexcept
+            : m_sa(nullptr), m_lcp(nullptr)
+        {
+        }
+
+        /// Build the suffix array of text, and the LCP array if with_lcp is true. Returns false if the text is
+        /// too large or the arena is too small, in which case the array is left empty and the arena is returned
+        /// to its previous mark.
+        bool build(const StringSlice& text, SliceArena& arena, bool with_lcp = true) noexcept
+        {
+            *this = SuffixArray();
+            size_t start_mark = arena.mark();
+            uint32_t n = text.size();
+            if ((uint64_t)n + 1 >= detail::sais_empty)
+            {
+                return false;
+            }
+
+            // Slot 0 gets the sentinel suffix, which is dropped.
+            uint32_t* sa = arena.allocate<uint32_t>((size_t)n + 1);
+            uint32_t* lcp = with_lcp ? arena.allocate<uint32_t>(n) : nullptr;
+            if (!sa || (with_lcp && !lcp) ||
+                (n > 0 && !detail::sais(detail::SaisText{ (const unsigned char*)text.data(), n }, sa, n + 1, 256, arena)))
+            {
+                arena.release(start_mark);
+                return false;
+            }
+
+            m_text = text;
+            m_sa = sa + 1;
+            if (with_lcp && !build_lcp(lcp, arena))
+            {
+                *this = SuffixArray();
+                arena.release(start_mark);
+                return false;
+            }
+
+            return true;
+        }
+
+        /// Returns the indexed text.
+        const StringSlice& text() const noexcept { return m_text; }
+
+        /// Returns the number of suffixes, which is the size of the text.
+        size_t size() const noexcept { return m_sa ? m_text.size() : 0; }
+
+        /// Returns true if the LCP array was built.
+        bool has_lcp() const noexcept { return m_lcp != nullptr; }
+
+        /// Get the text position of the i-th smallest suffix without range checking.
+        size_type position(size_t i) const noexcept { return m_sa[i]; }
+
+        /// Get the common prefix size of the i-th smallest suffix and the one before it, or 0 for the first,
+        /// without range checking. Requires the LCP array.
+        size_type lcp(size_t i) const noexcept { return m_lcp[i]; }
+
+        /// Get the range [first, last) of sorted suffixes that start with pattern. The range is empty if the
+        /// pattern does not occur. An empty pattern matches every suffix.
+        void range(const StringSlice& pattern, size_t& first, size_t& last) const noexcept
+        {
+            first = bound(pattern, false);
+            last = bound(pattern, true);
+        }
+
+        /// Returns the number of times pattern occurs in the text, counting overlapping matches.
+        size_t count(const StringSlice& pattern) const noexcept
+        {
+            size_t first;
+            size_t last;
+            range(pattern, first, last);
+            return last - first;
+        }
+
+        /// Call fn(size_type position) for every position where pattern occurs in the text. Positions are
+        /// reported in suffix order, not text order. Returns the number of occurrences.
+        template<typename Fn>
+        size_t locate(const StringSlice& pattern, Fn&& fn) const noexcept
+        {
+            size_t first;
+            size_t last;
+            range(pattern, first, last);
+            for (size_t i = first; i < last; ++i)
+            {
+                fn((size_type)m_sa[i]);
+            }
+
+            return last - first;
+        }
+
+        /// Returns the longest substring that occurs at least twice (the occurrences may overlap), at its first
+        /// position in suffix order. Returns an empty slice if no byte repeats or there is no LCP array.
+        StringSlice longest_repeated_substring() const noexcept
+        {
+            size_t best = 0;
+            for (size_t i = 1; m_lcp && i < m_text.size(); ++i)
+            {
+                best = m_lcp[i] > m_lcp[best] ? i : best;
+            }
+
+            if (!m_lcp || m_text.size() == 0 || m_lcp[best] == 0)
+            {
+                return StringSlice(m_text.data(), 0);
+            }
+
+            return StringSlice(m_text.data() + m_sa[best], m_lcp[best]);
+        }
+
+    private:
+        /// Kasai's algorithm: walking the text in position order, the common prefix with the previous suffix in
+        /// sorted order drops by at most one per step. Uses the rank of each suffix as scratch.
+        bool build_lcp(uint32_t* lcp, SliceArena& arena) noexcept
+        {
+            uint32_t n = m_text.size();
+            size_t start_mark = arena.mark();
+            uint32_t* rank = arena.allocate<uint32_t>(n);
+            if (!rank && n > 0)
+            {
+                return false;
+            }
+
+            for (uint32_t i = 0; i < n; ++i)
+            {
+                rank[m_sa[i]] = i;
+            }
+
+            const char* t = m_text.data();
+            uint32_t h = 0;
+            for (uint32_t pos = 0; pos < n; ++pos)
+            {
+                if (rank[pos] == 0)
+                {
+                    lcp[0] = 0;
+                    h = 0;
+                    continue;
+                }
+
+                uint32_t other = m_sa[rank[pos] - 1];
+                while (pos + h < n && other + h < n && t[pos + h] == t[other + h])
+                {
+                    ++h;
+                }
+
+                lcp[rank[pos]] = h;
+                h = h > 0 ? h - 1 : 0;
+            }
+
+            arena.release(start_mark);
+            m_lcp = lcp;
+            return true;
+        }
+
+        /// Compare the start of a suffix to the pattern, skipping the first matched bytes that are known to be
+        /// equal. Returns less than 0 if the suffix goes before the pattern, 0 if it starts with the pattern, and
+        /// more than 0 if it goes after. matched is set to the common prefix size.
+        int compare_at(uint32_t pos, const StringSlice& pattern, size_type& matched) const noexcept
+        {
+            const unsigned char* t = (const unsigned char*)m_text.data() + pos;
+            const unsigned char* p = (const unsigned char*)pattern.data();
+            size_type rest = m_text.size() - pos;
+            size_type n = rest < pattern.size() ? rest : pattern.size();
+            while (matched < n && t[matched] == p[matched])
+            {
+                ++matched;
+            }
+
+            if (matched == pattern.size())
+            {
+                return 0;
+            }
+
+            return matched == rest || t[matched] < p[matched] ? -1 : 1;
+        }
+
+        /// First sorted suffix that does not go before the pattern, or with upper, that goes after it. The
+        /// suffixes between the bounds share at least the smaller of the bounds' common prefixes with the
+        /// pattern, so each comparison starts there.
+        size_t bound(const StringSlice& pattern, bool upper) const noexcept
+        {
+            size_t lo = 0;
+            size_t hi = size();
+            size_type lo_match = 0;
+            size_type hi_match = 0;
+            while (lo < hi)
+            {
+                size_t mid = lo + (hi - lo) / 2;
+                size_type matched = lo_match < hi_match ? lo_match : hi_match;
+                int c = compare_at(m_sa[mid], pattern, matched);
+                if (c < 0 || (upper && c == 0))
+                {
+                    lo = mid + 1;
+                    lo_match = matched;
+                }
+                else
+                {
+                    hi = mid;
+                    hi_match = matched;
+                }
+            }
+
+            return lo;
+        }
+
+        StringSlice m_text;
+        const uint32_t* m_sa;
+        const uint32_t* m_lcp;
+    };
+}
+
+#endif // _SCOTTZ0R_SUFFIX_ARRAY_INCLUDE_GUARD
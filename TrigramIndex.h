@@ -0,0 +1,482 @@
+/// @file
+/// Defines the TrigramIndex object.
+#ifndef _SCOTTZ0R_TRIGRAM_INDEX_INCLUDE_GUARD
+#define _SCOTTZ0R_TRIGRAM_INDEX_INCLUDE_GUARD
+
+#include <algorithm>
+#include <vector>
+
+#include "StringSlice.h"
+#include "SliceExecutor.h"
+
+namespace scottz0r
+{
+    /// Substring search index over many documents. For every 3 byte sequence (trigram), the index keeps the
+    /// sorted list of documents that contain it, stored as varint coded gaps. find looks up the rarest trigrams
+    /// of the needle, intersects their lists, and checks only the documents left with StringSlice::find, so a
+    /// search over millions of records reads a few short lists instead of all the text.
+    ///
+    /// The index does not keep the documents; find takes the same array that was indexed. Documents are numbered
+    /// by their position in the array, and only the first 4G are indexed.
+    ///
+    /// The index is one block of memory: a header, the sorted trigram table, and the lists. data() and
+    /// size_bytes() can be written to a file and used again with load, for example straight from a memory map.
+    /// The format uses the byte order of the machine that wrote it.
+    ///
+    /// Building allocates from the heap and can throw std::bad_alloc; lookups do not allocate or throw.
+    class TrigramIndex
+    {
+    public:
+        using size_type = StringSlice::size_type;
+
+        /// Number of words in the header.
+        static constexpr size_t header_words = 4;
+
+        /// Most trigrams of a needle used to pick candidates. The rarest are used; the rest are only checked
+        /// by the final find.
+        static constexpr unsigned int max_query_grams = 16;
+
+        /// Construct an empty index of no documents.
+        TrigramIndex() noexcept
+            : m_data(nullptr), m_doc_count(0), m_gram_count(0), m_grams(nullptr), m_counts(nullptr),
+            m_offsets(nullptr), m_lists(nullptr)
+        {
+        }
+
+        TrigramIndex(TrigramIndex&&) = default;
+        TrigramIndex& operator=(TrigramIndex&&) = default;
+
+        /// Not copyable, because a built index points into its own storage.
+        TrigramIndex(const TrigramIndex&) = delete;
+        TrigramIndex& operator=(const TrigramIndex&) = delete;
+
+        /// Index an array of documents using the given executor (see SliceExecutor.h). Each part of the
+        /// documents collects and sorts its (trigram, document) pairs, and then each range of trigrams is merged
+        /// and coded as a separate task. The tasks allocate, so they run through run_rethrow: std::bad_alloc in
+        /// any of them is thrown here once they all finish, and the index is left empty.
+        template<typename Executor>
+        void build(const StringSlice* docs, size_t count, Executor& executor)
+        {
+            *this = TrigramIndex();
+            count = count < 0xFFFFFFFFull ? count : 0xFFFFFFFFull;
+
+            unsigned int tasks = executor.concurrency() * 4;
+            tasks = tasks < max_tasks ? tasks : max_tasks;
+            tasks = count < tasks ? (count > 0 ? (unsigned int)count : 1) : tasks;
+
+            // Pairs are (trigram << 32) | document, so sorting them sorts by trigram and then document.
+            std::vector<std::vector<uint64_t>> chunk_pairs(tasks);
+            run_rethrow(executor, tasks, [&](unsigned int c) {
+                std::vector<uint64_t>& pairs = chunk_pairs[c];
+                std::vector<uint32_t> grams;
+                for (size_t d = count * c / tasks; d < count * (c + 1) / tasks; ++d)
+                {
+                    grams.clear();
+                    for (size_type i = 0; i + 3 <= docs[d].size(); ++i)
+                    {
+                        grams.push_back(gram_at(docs[d].data() + i));
+                    }
+
+                    std::sort(grams.begin(), grams.end());
+                    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+                    for (uint32_t g : grams)
+                    {
+                        pairs.push_back(((uint64_t)g << 32) | (uint64_t)d);
+                    }
+                }
+
+                std::sort(pairs.begin(), pairs.end());
+            });
+
+            struct Part
+            {
+                std::vector<uint32_t> grams;
+                std::vector<uint32_t> counts;
+                std::vector<uint64_t> offsets;
+                std::vector<unsigned char> lists;
+            };
+
+            std::vector<Part> parts(tasks);
+            run_rethrow(executor, tasks, [&](unsigned int p) {
+                uint64_t lo = part_start(p, tasks) << 32;
+                uint64_t hi = part_start(p + 1, tasks) << 32;
+                std::vector<uint64_t> pairs;
+                for (const auto& chunk : chunk_pairs)
+                {
+                    auto first = std::lower_bound(chunk.begin(), chunk.end(), lo);
+                    auto last = std::lower_bound(first, chunk.end(), hi);
+                    pairs.insert(pairs.end(), first, last);
+                }
+
+                std::sort(pairs.begin(), pairs.end());
+
+                Part& part = parts[p];
+                uint32_t prev = 0;
+                for (uint64_t pair : pairs)
+                {
+                    uint32_t g = (uint32_t)(pair >> 32);
+                    uint32_t d = (uint32_t)pair;
+                    if (part.grams.empty() || part.grams.back() != g)
+                    {
+                        part.grams.push_back(g);
+                        part.counts.push_back(0);
+                        part.offsets.push_back(part.lists.size());
+                        prev = 0;
+                    }
+
+                    unsigned char buffer[10];
+                    unsigned char* end = bits::put_varint(buffer, d - prev);
+                    part.lists.insert(part.lists.end(), buffer, end);
+                    ++part.counts.back();
+                    prev = d;
+                }
+            });
+
+            size_t gram_count = 0;
+            size_t list_bytes = 0;
+            for (const auto& part : parts)
+            {
+                gram_count += part.grams.size();
+                list_bytes += part.lists.size();
+            }
+
+            m_storage.assign(storage_words(gram_count, list_bytes), 0);
+            m_storage[0] = magic();
+            m_storage[1] = count;
+            m_storage[2] = gram_count;
+            m_storage[3] = list_bytes;
+            set_pointers();
+            uint32_t* grams = const_cast<uint32_t*>(m_grams);
+            uint32_t* counts = const_cast<uint32_t*>(m_counts);
+            uint64_t* offsets = const_cast<uint64_t*>(m_offsets);
+            unsigned char* lists = const_cast<unsigned char*>(m_lists);
+
+            size_t g = 0;
+            size_t offset = 0;
+            for (const auto& part : parts)
+            {
+                std::copy(part.grams.begin(), part.grams.end(), grams + g);
+                std::copy(part.counts.begin(), part.counts.end(), counts + g);
+                for (size_t i = 0; i < part.offsets.size(); ++i)
+                {
+                    offsets[g + i] = offset + part.offsets[i];
+                }
+
+                std::copy(part.lists.begin(), part.lists.end(), lists + offset);
+                g += part.grams.size();
+                offset += part.lists.size();
+            }
+
+            offsets[gram_count] = offset;
+        }
+
+        /// Index an array of documents on the calling thread.
+        void build(const StringSlice* docs, size_t count)
+        {
+            SerialExecutor executor;
+            build(docs, count, executor);
+        }
+
+        /// Use an index serialized from data() and size_bytes(). data must be 8 byte aligned and stay valid while
+        /// the index is used. The whole index is read once to check it, so lookups into a truncated or corrupted
+        /// file cannot read out of bounds. Returns false if the data is not a valid index, in which case the index
+        /// is left empty.
+        bool load(const void* data, size_t size) noexcept
+        {
+            *this = TrigramIndex();
+            const uint64_t* words = (const uint64_t*)data;
+            if (!data || (uintptr_t)data % alignof(uint64_t) != 0 || size < header_words * sizeof(uint64_t) ||
+                words[0] != magic() || words[1] > 0xFFFFFFFFull || words[2] > (1u << 24) ||
+                words[3] > size || storage_words((size_t)words[2], (size_t)words[3]) > size / sizeof(uint64_t))
+            {
+                return false;
+            }
+
+            m_data = words;
+            set_pointers();
+            if (!check_tables())
+            {
+                *this = TrigramIndex();
+                return false;
+            }
+
+            return true;
+        }
+
+        /// Returns the serialized index, size_bytes() long.
+        const void* data() const noexcept { return m_data; }
+
+        /// Returns the size of the serialized index.
+        size_t size_bytes() const noexcept
+        {
+            return m_data ? storage_words(m_gram_count, (size_t)m_data[3]) * sizeof(uint64_t) : 0;
+        }
+
+        /// Returns the number of indexed documents.
+        size_t document_count() const noexcept { return m_doc_count; }
+
+        /// Returns the number of distinct trigrams.
+        size_t gram_count() const noexcept { return m_gram_count; }
+
+        /// Returns the number of documents that contain a trigram. Only the first 3 bytes of gram are used.
+        size_t gram_documents(const StringSlice& gram) const noexcept
+        {
+            size_t i = gram.size() >= 3 ? find_gram(gram_at(gram.data())) : m_gram_count;
+            return i < m_gram_count ? m_counts[i] : 0;
+        }
+
+        /// Call fn(size_t doc, size_type pos) for each document that contains needle, in order, with the position
+        /// of the first match. docs must be the array that was indexed. Needles shorter than 3 bytes cannot use
+        /// the index and check every document. Returns the number of documents found.
+        template<typename Fn>
+        size_t find(const StringSlice& needle, const StringSlice* docs, Fn&& fn) const noexcept
+        {
+            size_t found = 0;
+            auto check = [&](size_t d) {
+                size_type pos = docs[d].find(needle);
+                if (pos != StringSlice::npos)
+                {
+                    fn(d, pos);
+                    ++found;
+                }
+            };
+
+            if (needle.size() < 3)
+            {
+                for (size_t d = 0; d < m_doc_count; ++d)
+                {
+                    check(d);
+                }
+
+                return found;
+            }
+
+            // Keep the rarest trigrams, sorted by list size.
+            Cursor cursors[max_query_grams];
+            unsigned int used = 0;
+            for (size_type i = 0; i + 3 <= needle.size(); ++i)
+            {
+                size_t g = find_gram(gram_at(needle.data() + i));
+                if (g == m_gram_count)
+                {
+                    return 0;
+                }
+
+                bool repeated = false;
+                for (unsigned int j = 0; j < used; ++j)
+                {
+                    repeated = repeated || cursors[j].gram == g;
+                }
+
+                if (repeated || (used == max_query_grams && m_counts[g] >= cursors[used - 1].remaining))
+                {
+                    continue;
+                }
+
+                unsigned int j = used < max_query_grams ? used++ : used - 1;
+                for (; j > 0 && cursors[j - 1].remaining > m_counts[g]; --j)
+                {
+                    cursors[j] = cursors[j - 1];
+                }
+
+                cursors[j] = Cursor(g, m_lists + m_offsets[g], m_counts[g]);
+            }
+
+            // Walk the shortest list and move the others forward to each of its documents.
+            Cursor& lead = cursors[0];
+            while (lead.next())
+            {
+                unsigned int j = 1;
+                for (; j < used; ++j)
+                {
+                    // Once any list runs out, no later document can match.
+                    if (!cursors[j].skip_to(lead.doc))
+                    {
+                        return found;
+                    }
+
+                    if (cursors[j].doc != lead.doc)
+                    {
+                        break;
+                    }
+                }
+
+                if (j == used)
+                {
+                    check(lead.doc);
+                }
+            }
+
+            return found;
+        }
+
+    private:
+        /// Upper bound on the number of build tasks.
+        static constexpr unsigned int max_tasks = 256;
+
+        /// Position in a list. doc is the last document read.
+        struct Cursor
+        {
+            size_t gram;
+            const unsigned char* p;
+            size_t remaining;
+            uint32_t doc;
+            bool started;
+
+            Cursor() noexcept
+                : gram(0), p(nullptr), remaining(0), doc(0), started(false)
+            {
+            }
+
+            Cursor(size_t g, const unsigned char* list, size_t count) noexcept
+                : gram(g), p(list), remaining(count), doc(0), started(false)
+            {
+            }
+
+            bool next() noexcept
+            {
+                if (remaining == 0)
+                {
+                    return false;
+                }
+
+                uint64_t gap;
+                p = bits::get_varint(p, gap);
+                doc = started ? doc + (uint32_t)gap : (uint32_t)gap;
+                started = true;
+                --remaining;
+                return true;
+            }
+
+            /// Advance until doc is at least target. Returns false if the list ends first.
+            bool skip_to(uint32_t target) noexcept
+            {
+                while (!started || doc < target)
+                {
+                    if (!next())
+                    {
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+        };
+
+        static uint64_t magic() noexcept { return bits::load_u64("SZTRGM01"); }
+
+        static uint32_t gram_at(const char* p) noexcept
+        {
+            return ((uint32_t)(unsigned char)p[0] << 16) | ((uint32_t)(unsigned char)p[1] << 8) |
+                (uint32_t)(unsigned char)p[2];
+        }
+
+        /// First trigram of build partition p, splitting the 24-bit trigram space evenly.
+        static uint64_t part_start(unsigned int p, unsigned int parts) noexcept
+        {
+            return ((uint64_t)p << 24) / parts;
+        }
+
+        /// Layout after the header: trigrams and list sizes as 32-bit arrays, list offsets as 64-bit, then lists.
+        static size_t storage_words(size_t gram_count, size_t list_bytes) noexcept
+        {
+            size_t table = (gram_count + 1) / 2;
+            return header_words + 2 * table + gram_count + 1 + (list_bytes + 7) / 8;
+        }
+
+        void set_pointers() noexcept
+        {
+            if (!m_storage.empty())
+            {
+                m_data = m_storage.data();
+            }
+
+            m_doc_count = (size_t)m_data[1];
+            m_gram_count = (size_t)m_data[2];
+            size_t table = (m_gram_count + 1) / 2;
+            m_grams = (const uint32_t*)(m_data + header_words);
+            m_counts = (const uint32_t*)(m_data + header_words + table);
+            m_offsets = m_data + header_words + 2 * table;
+            m_lists = (const unsigned char*)(m_offsets + m_gram_count + 1);
+        }
+
+        /// Check loaded tables: trigrams strictly increasing, list offsets increasing from 0 to the list size, and
+        /// each list holding exactly its count of varints for increasing documents below document_count().
+        bool check_tables() const noexcept
+        {
+            const uint64_t list_bytes = m_data[3];
+            if (m_offsets[0] != 0 || m_offsets[m_gram_count] != list_bytes)
+            {
+                return false;
+            }
+
+            for (size_t g = 0; g < m_gram_count; ++g)
+            {
+                uint64_t begin = m_offsets[g];
+                uint64_t end = m_offsets[g + 1];
+                if (m_grams[g] >= (1u << 24) || (g > 0 && m_grams[g] <= m_grams[g - 1]) || end < begin ||
+                    end > list_bytes || m_counts[g] == 0)
+                {
+                    return false;
+                }
+
+                uint64_t pos = begin;
+                uint64_t doc = 0;
+                for (uint32_t i = 0; i < m_counts[g]; ++i)
+                {
+                    // Gaps are below 2^32, so a varint is at most 5 bytes.
+                    uint64_t gap = 0;
+                    unsigned int shift = 0;
+                    unsigned char byte;
+                    do
+                    {
+                        if (pos == end || shift > 28)
+                        {
+                            return false;
+                        }
+
+                        byte = m_lists[pos++];
+                        gap |= (uint64_t)(byte & 0x7F) << shift;
+                        shift += 7;
+                    } while (byte & 0x80);
+
+                    if (i > 0 && gap == 0)
+                    {
+                        return false;
+                    }
+
+                    doc += gap;
+                    if (doc >= m_doc_count)
+                    {
+                        return false;
+                    }
+                }
+
+                if (pos != end)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        /// Returns the index of a trigram in the table, or gram_count() if it is not there.
+        size_t find_gram(uint32_t gram) const noexcept
+        {
+            const uint32_t* it = std::lower_bound(m_grams, m_grams + m_gram_count, gram);
+            return it != m_grams + m_gram_count && *it == gram ? (size_t)(it - m_grams) : m_gram_count;
+        }
+
+        std::vector<uint64_t> m_storage;
+        const uint64_t* m_data;
+        size_t m_doc_count;
+        size_t m_gram_count;
+        const uint32_t* m_grams;
+        const uint32_t* m_counts;
+        const uint64_t* m_offsets;
+        const unsigned char* m_lists;
+    };
+}
+
+#endif // _SCOTTZ0R_TRIGRAM_INDEX_INCLUDE_GUARD
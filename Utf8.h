@@ -0,0 +1,636 @@
+/// @file
+/// UTF-8 validation, codepoint counting, decoding and UTF-16/UTF-32 transcoding for StringSlice.
+#ifndef _SCOTTZ0R_UTF8_INCLUDE_GUARD
+#define _SCOTTZ0R_UTF8_INCLUDE_GUARD
+
+#include "StringSlice.h"
+
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#define SCOTTZ0R_UTF8_HAS_SSSE3 1
+#endif
+
+namespace scottz0r
+{
+    /// Codepoint returned by Utf8Iterator for invalid sequences.
+    static constexpr uint32_t utf8_replacement_char = 0xFFFD;
+
+    namespace detail
+    {
+        // Error bits for the Keiser-Lemire lookup tables. Each table is indexed by a nibble of either the
+        // previous byte or the current byte, and the three results are ANDed together. A bit that survives the
+        // AND is an error, except TWO_CONTS, which is expected when the byte two or three back is a 3 or 4 byte
+        // lead.
+        static constexpr uint8_t utf8_too_short = 1 << 0;
+        static constexpr uint8_t utf8_too_long = 1 << 1;
+        static constexpr uint8_t utf8_overlong_3 = 1 << 2;
+        static constexpr uint8_t utf8_too_large = 1 << 3;
+        static constexpr uint8_t utf8_surrogate = 1 << 4;
+        static constexpr uint8_t utf8_overlong_2 = 1 << 5;
+        static constexpr uint8_t utf8_too_large_1000 = 1 << 6;
+        static constexpr uint8_t utf8_overlong_4 = 1 << 6;
+        static constexpr uint8_t utf8_two_conts = 1 << 7;
+        static constexpr uint8_t utf8_carry = utf8_too_short | utf8_too_long | utf8_two_conts;
+
+        /// Lookup on the high nibble of the previous byte.
+        inline const uint8_t* utf8_byte_1_high() noexcept
+        {
+            static const uint8_t table[16] = {
+                // 0_______ ________ <ASCII in byte 1>
+                utf8_too_long, utf8_too_long, utf8_too_long, utf8_too_long,
+                utf8_too_long, utf8_too_long, utf8_too_long, utf8_too_long,
+                // 10______ ________ <continuation in byte 1>
+                utf8_two_conts, utf8_two_conts, utf8_two_conts, utf8_two_conts,
+                // 1100____ ________ <two byte lead in byte 1>
+                utf8_too_short | utf8_overlong_2,
+                // 1101____ ________ <two byte lead in byte 1>
+                utf8_too_short,
+                // 1110____ ________ <three byte lead in byte 1>
+                utf8_too_short | utf8_overlong_3 | utf8_surrogate,
+                // 1111____ ________ <four+ byte lead in byte 1>
+                utf8_too_short | utf8_too_large | utf8_too_large_1000 | utf8_overlong_4,
+            };
+            return table;
+        }
+
+        /// Lookup on the low nibble of the previous byte.
+        inline const uint8_t* utf8_byte_1_low() noexcept
+        {
+            static const uint8_t table[16] = {
+                // ____0000 ________
+                utf8_carry | utf8_overlong_3 | utf8_overlong_2 | utf8_overlong_4,
+                // ____0001 ________
+                utf8_carry | utf8_overlong_2,
+                // ____001_ ________
+                utf8_carry,
+                utf8_carry,
+                // ____0100 ________
+                utf8_carry | utf8_too_large,
+                // ____0101 ________
+                utf8_carry | utf8_too_large | utf8_too_large_1000,
+                // ____011_ ________
+                utf8_carry | utf8_too_large | utf8_too_large_1000,
+                utf8_carry | utf8_too_large | utf8_too_large_1000,
+                // ____1___ ________
+                utf8_carry | utf8_too_large | utf8_too_large_1000,
+                utf8_carry | utf8_too_large | utf8_too_large_1000,
+                utf8_carry | utf8_too_large | utf8_too_large_1000,
+                utf8_carry | utf8_too_large | utf8_too_large_1000,
+                utf8_carry | utf8_too_large | utf8_too_large_1000,
+                // ____1101 ________
+                utf8_carry | utf8_too_large | utf8_too_large_1000 | utf8_surrogate,
+                utf8_carry | utf8_too_large | utf8_too_large_1000,
+                utf8_carry | utf8_too_large | utf8_too_large_1000,
+            };
+            return table;
+        }
+
+        /// Lookup on the high nibble of the current byte.
+        inline const uint8_t* utf8_byte_2_high() noexcept
+        {
+            static const uint8_t table[16] = {
+                // ________ 0_______ <ASCII in byte 2>
+                utf8_too_short, utf8_too_short, utf8_too_short, utf8_too_short,
+                utf8_too_short, utf8_too_short, utf8_too_short, utf8_too_short,
+                // ________ 1000____
+                utf8_too_long | utf8_overlong_2 | utf8_two_conts | utf8_overlong_3 | utf8_too_large_1000 |
+                    utf8_overlong_4,
+                // ________ 1001____
+                utf8_too_long | utf8_overlong_2 | utf8_two_conts | utf8_overlong_3 | utf8_too_large,
+                // ________ 101_____
+                utf8_too_long | utf8_overlong_2 | utf8_two_conts | utf8_surrogate | utf8_too_large,
+                utf8_too_long | utf8_overlong_2 | utf8_two_conts | utf8_surrogate | utf8_too_large,
+                // ________ 11______
+                utf8_too_short, utf8_too_short, utf8_too_short, utf8_too_short,
+            };
+            return table;
+        }
+
+        /// Validate one block of bytes with the lookup tables. prev1 through prev3 carry the last bytes of the
+        /// previous block. Returns non-zero if an error was found.
+        inline uint8_t utf8_check_scalar(const uint8_t* p, StringSlice::size_type len, uint8_t& prev1, uint8_t& prev2,
+            uint8_t& prev3) noexcept
+        {
+            const uint8_t* t1 = utf8_byte_1_high();
+            const uint8_t* t2 = utf8_byte_1_low();
+            const uint8_t* t3 = utf8_byte_2_high();
+
+            uint8_t error = 0;
+            for (StringSlice::size_type i = 0; i < len; ++i)
+            {
+                uint8_t cur = p[i];
+                uint8_t special = t1[prev1 >> 4] & t2[prev1 & 0x0F] & t3[cur >> 4];
+                uint8_t must_be_23 = (prev2 >= 0xE0 || prev3 >= 0xF0) ? 0x80 : 0;
+                error |= special ^ must_be_23;
+
+                prev3 = prev2;
+                prev2 = prev1;
+                prev1 = cur;
+            }
+
+            return error;
+        }
+
+        /// Returns true if the last bytes seen start a sequence that has not been completed.
+        inline bool utf8_incomplete(uint8_t prev1, uint8_t prev2, uint8_t prev3) noexcept
+        {
+            return prev1 >= 0xC0 || prev2 >= 0xE0 || prev3 >= 0xF0;
+        }
+
+#if defined(SCOTTZ0R_UTF8_HAS_SSSE3)
+        /// Check one 16 byte block. Same algorithm as utf8_check_scalar, with the tables in registers.
+        inline __m128i utf8_check_block_ssse3(__m128i input, __m128i prev_input) noexcept
+        {
+            const __m128i nibble = _mm_set1_epi8(0x0F);
+            const __m128i t1 = _mm_loadu_si128((const __m128i*)utf8_byte_1_high());
+            const __m128i t2 = _mm_loadu_si128((const __m128i*)utf8_byte_1_low());
+            const __m128i t3 = _mm_loadu_si128((const __m128i*)utf8_byte_2_high());
+
+            __m128i prev1 = _mm_alignr_epi8(input, prev_input, 15);
+            __m128i prev2 = _mm_alignr_epi8(input, prev_input, 14);
+            __m128i prev3 = _mm_alignr_epi8(input, prev_input, 13);
+
+            __m128i b1h = _mm_shuffle_epi8(t1, _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble));
+            __m128i b1l = _mm_shuffle_epi8(t2, _mm_and_si128(prev1, nibble));
+            __m128i b2h = _mm_shuffle_epi8(t3, _mm_and_si128(_mm_srli_epi16(input, 4), nibble));
+            __m128i special = _mm_and_si128(_mm_and_si128(b1h, b1l), b2h);
+
+            // The high bit of the saturated difference is set when prev2 >= 0xE0 or prev3 >= 0xF0.
+            __m128i third = _mm_subs_epu8(prev2, _mm_set1_epi8((char)(0xE0 - 0x80)));
+            __m128i fourth = _mm_subs_epu8(prev3, _mm_set1_epi8((char)(0xF0 - 0x80)));
+            __m128i must_be_23 = _mm_and_si128(_mm_or_si128(third, fourth), _mm_set1_epi8((char)0x80));
+
+            return _mm_xor_si128(must_be_23, special);
+        }
+
+        inline bool utf8_validate_ssse3(const StringSlice& slice) noexcept
+        {
+            const uint8_t* p = (const uint8_t*)slice.data();
+            StringSlice::size_type size = slice.size();
+
+            // Bytes that, in the last three positions of a block, start a sequence that continues in the next block.
+            const __m128i max_value = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                (char)(0xF0 - 1), (char)(0xE0 - 1), (char)(0xC0 - 1));
+
+            __m128i error = _mm_setzero_si128();
+            __m128i prev_input = _mm_setzero_si128();
+            __m128i prev_incomplete = _mm_setzero_si128();
+
+            StringSlice::size_type i = 0;
+            for (;;)
+            {
+                __m128i input;
+                if (i + 16 <= size)
+                {
+                    input = _mm_loadu_si128((const __m128i*)(p + i));
+                }
+                else if (i < size)
+                {
+                    uint8_t tail[16] = {};
+                    memcpy(tail, p + i, size - i);
+                    input = _mm_loadu_si128((const __m128i*)tail);
+                }
+                else
+                {
+                    break;
+                }
+
+                if (_mm_movemask_epi8(input) == 0)
+                {
+                    // An ASCII block is only an error if the previous block ended mid sequence.
+                    error = _mm_or_si128(error, prev_incomplete);
+                    prev_incomplete = _mm_setzero_si128();
+                }
+                else
+                {
+                    error = _mm_or_si128(error, utf8_check_block_ssse3(input, prev_input));
+                    prev_incomplete = _mm_subs_epu8(input, max_value);
+                }
+
+                prev_input = input;
+                i += 16;
+            }
+
+            error = _mm_or_si128(error, prev_incomplete);
+            return _mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) == 0xFFFF;
+        }
+#endif
+
+        /// Decode one codepoint from [p, p + avail). avail must be at least 1. Returns the number of bytes in the
+        /// sequence, or 0 if the sequence is invalid or truncated.
+        inline unsigned int utf8_decode(const char* p, StringSlice::size_type avail, uint32_t& codepoint) noexcept
+        {
+            uint8_t b0 = (uint8_t)p[0];
+            if (b0 < 0x80)
+            {
+                codepoint = b0;
+                return 1;
+            }
+
+            unsigned int len;
+            uint32_t min;
+            if (b0 >= 0xC2 && b0 <= 0xDF)
+            {
+                len = 2;
+                min = 0x80;
+                codepoint = b0 & 0x1F;
+            }
+            else if (b0 >= 0xE0 && b0 <= 0xEF)
+            {
+                len = 3;
+                min = 0x800;
+                codepoint = b0 & 0x0F;
+            }
+            else if (b0 >= 0xF0 && b0 <= 0xF4)
+            {
+                len = 4;
+                min = 0x10000;
+                codepoint = b0 & 0x07;
+            }
+            else
+            {
+                return 0;
+            }
+
+            if (avail < len)
+            {
+                return 0;
+            }
+
+            for (unsigned int i = 1; i < len; ++i)
+            {
+                uint8_t b = (uint8_t)p[i];
+                if ((b & 0xC0) != 0x80)
+                {
+                    return 0;
+                }
+
+                codepoint = (codepoint << 6) | (b & 0x3F);
+            }
+
+            if (codepoint < min || codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF))
+            {
+                return 0;
+            }
+
+            return len;
+        }
+    }
+
+    /// Returns true if the slice is valid UTF-8: no overlong encodings, surrogates, codepoints above U+10FFFF or
+    /// truncated sequences. Uses the Keiser-Lemire lookup table algorithm, 16 bytes at a time with SSSE3 when the
+    /// compiler targets it. Otherwise, runs of ASCII are skipped 16 bytes at a time and the same tables are applied
+    /// a byte at a time.
+    inline bool is_valid_utf8(const StringSlice& slice) noexcept
+    {
+#if defined(SCOTTZ0R_UTF8_HAS_SSSE3)
+        return detail::utf8_validate_ssse3(slice);
+#else
+        const uint8_t* p = (const uint8_t*)slice.data();
+        StringSlice::size_type size = slice.size();
+
+        uint8_t prev1 = 0;
+        uint8_t prev2 = 0;
+        uint8_t prev3 = 0;
+        uint8_t error = 0;
+
+        StringSlice::size_type i = 0;
+        while (i < size)
+        {
+            StringSlice::size_type len = size - i < 16 ? size - i : 16;
+
+            if (len == 16 && !detail::utf8_incomplete(prev1, prev2, prev3))
+            {
+                uint64_t word = bits::load_u64(slice.data() + i) | bits::load_u64(slice.data() + i + 8);
+                if ((word & 0x8080808080808080ull) == 0)
+                {
+                    prev1 = prev2 = prev3 = 0;
+                    i += 16;
+                    continue;
+                }
+            }
+
+            error |= detail::utf8_check_scalar(p + i, len, prev1, prev2, prev3);
+            i += len;
+        }
+
+        return error == 0 && !detail::utf8_incomplete(prev1, prev2, prev3);
+#endif
+    }
+
+    /// Returns the number of codepoints in the slice. This counts the bytes that are not continuation bytes, so
+    /// it is only exact for valid UTF-8.
+    inline StringSlice::size_type utf8_length(const StringSlice& slice) noexcept
+    {
+        const char* p = slice.data();
+        StringSlice::size_type size = slice.size();
+        StringSlice::size_type continuations = 0;
+
+        StringSlice::size_type i = 0;
+        for (; i + 8 <= size; i += 8)
+        {
+            // A continuation byte has bit 7 set and bit 6 clear.
+            uint64_t x = bits::load_u64(p + i);
+            continuations += bits::popcount64(x & ~(x << 1) & 0x8080808080808080ull);
+        }
+
+        for (; i < size; ++i)
+        {
+            continuations += ((uint8_t)p[i] & 0xC0) == 0x80;
+        }
+
+        return size - continuations;
+    }
+
+    /// Iterates over the codepoints of a UTF-8 slice. Invalid or truncated sequences are returned as
+    /// utf8_replacement_char and skip one byte. This class does not throw exceptions.
+    class Utf8Iterator
+    {
+    public:
+        using size_type = StringSlice::size_type;
+
+        /// Construct an iterator at the start of the slice. The iterator has the same lifetime as the slice.
+        Utf8Iterator(const StringSlice& slice) noexcept
+            : m_slice(slice), m_pos(0)
+        {
+        }
+
+        /// Get the next codepoint. Returns false if there are no more codepoints.
+        bool next(uint32_t& codepoint) noexcept
+        {
+            if (m_pos >= m_slice.size())
+            {
+                return false;
+            }
+
+            unsigned int len = detail::utf8_decode(m_slice.data() + m_pos, m_slice.size() - m_pos, codepoint);
+            if (len == 0)
+            {
+                codepoint = utf8_replacement_char;
+                len = 1;
+            }
+
+            m_pos += len;
+            return true;
+        }
+
+        /// Returns the byte offset of the next codepoint.
+        size_type position() const noexcept { return m_pos; }
+
+    private:
+        StringSlice m_slice;
+        size_type m_pos;
+    };
+    namespace detail
+    {
+        /// Widen 8 ASCII bytes to 8 code units.
+        template<typename CharT>
+        inline void utf8_widen_ascii8(const char* p, CharT* out) noexcept
+        {
+            for (unsigned int i = 0; i < 8; ++i)
+            {
+                out[i] = (CharT)(uint8_t)p[i];
+            }
+        }
+
+        /// Decode UTF-8 into 16 or 32 bit code units. Returns the number of units written, or npos if the input
+        /// is invalid or the output is too small.
+        template<typename CharT>
+        inline StringSlice::size_type utf8_transcode(const StringSlice& slice, CharT* out,
+            StringSlice::size_type capacity) noexcept
+        {
+            const char* p = slice.data();
+            StringSlice::size_type size = slice.size();
+            StringSlice::size_type i = 0;
+            StringSlice::size_type n = 0;
+
+            while (i < size)
+            {
+                // ASCII fast path, 8 bytes at a time.
+                if (i + 8 <= size && n + 8 <= capacity && (bits::load_u64(p + i) & 0x8080808080808080ull) == 0)
+                {
+                    utf8_widen_ascii8(p + i, out + n);
+                    i += 8;
+                    n += 8;
+                    continue;
+                }
+
+                uint32_t cp;
+                unsigned int len = utf8_decode(p + i, size - i, cp);
+                if (len == 0)
+                {
+                    return StringSlice::npos;
+                }
+
+                if (sizeof(CharT) == 2 && cp >= 0x10000)
+                {
+                    if (n + 2 > capacity)
+                    {
+                        return StringSlice::npos;
+                    }
+
+                    cp -= 0x10000;
+                    out[n++] = (CharT)(0xD800 + (cp >> 10));
+                    out[n++] = (CharT)(0xDC00 + (cp & 0x3FF));
+                }
+                else
+                {
+                    if (n + 1 > capacity)
+                    {
+                        return StringSlice::npos;
+                    }
+
+                    out[n++] = (CharT)cp;
+                }
+
+                i += len;
+            }
+
+            return n;
+        }
+
+        /// Encode one codepoint as UTF-8. Returns the number of bytes written, or 0 if there is not enough room.
+        inline unsigned int utf8_encode(uint32_t cp, char* out, StringSlice::size_type capacity) noexcept
+        {
+            if (cp < 0x80)
+            {
+                if (capacity < 1)
+                {
+                    return 0;
+                }
+
+                out[0] = (char)cp;
+                return 1;
+            }
+
+            if (cp < 0x800)
+            {
+                if (capacity < 2)
+                {
+                    return 0;
+                }
+
+                out[0] = (char)(0xC0 | (cp >> 6));
+                out[1] = (char)(0x80 | (cp & 0x3F));
+                return 2;
+            }
+
+            if (cp < 0x10000)
+            {
+                if (capacity < 3)
+                {
+                    return 0;
+                }
+
+                out[0] = (char)(0xE0 | (cp >> 12));
+                out[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+                out[2] = (char)(0x80 | (cp & 0x3F));
+                return 3;
+            }
+
+            if (capacity < 4)
+            {
+                return 0;
+            }
+
+            out[0] = (char)(0xF0 | (cp >> 18));
+            out[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+            out[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+            out[3] = (char)(0x80 | (cp & 0x3F));
+            return 4;
+        }
+    }
+
+    /// Returns the number of UTF-16 code units needed to hold a valid UTF-8 slice: one per codepoint, plus one
+    /// more for each codepoint above U+FFFF.
+    inline StringSlice::size_type utf16_length_from_utf8(const StringSlice& slice) noexcept
+    {
+        StringSlice::size_type four_byte = 0;
+        for (StringSlice::size_type i = 0; i < slice.size(); ++i)
+        {
+            four_byte += (uint8_t)slice[i] >= 0xF0;
+        }
+
+        return utf8_length(slice) + four_byte;
+    }
+
+    /// Returns the number of UTF-8 bytes needed to hold a valid UTF-16 string.
+    inline StringSlice::size_type utf8_length_from_utf16(const char16_t* in, StringSlice::size_type count) noexcept
+    {
+        StringSlice::size_type n = 0;
+        for (StringSlice::size_type i = 0; i < count; ++i)
+        {
+            char16_t c = in[i];
+            // A surrogate pair is 4 bytes, counted as 2 for each half.
+            n += c < 0x80 ? 1 : (c < 0x800 || (c >= 0xD800 && c <= 0xDFFF)) ? 2 : 3;
+        }
+
+        return n;
+    }
+
+    /// Returns the number of UTF-8 bytes needed to hold a valid UTF-32 string.
+    inline StringSlice::size_type utf8_length_from_utf32(const char32_t* in, StringSlice::size_type count) noexcept
+    {
+        StringSlice::size_type n = 0;
+        for (StringSlice::size_type i = 0; i < count; ++i)
+        {
+            char32_t c = in[i];
+            n += c < 0x80 ? 1 : c < 0x800 ? 2 : c < 0x10000 ? 3 : 4;
+        }
+
+        return n;
+    }
+
+    /// Convert UTF-8 to UTF-16, validating the input in the same pass. Returns the number of code units written,
+    /// or StringSlice::npos if the input is not valid UTF-8 or the output is too small. The output is not null
+    /// terminated. Size the output with utf16_length_from_utf8, or use slice.size() as an upper bound.
+    inline StringSlice::size_type transcode_utf8_to_utf16(const StringSlice& slice, char16_t* out,
+        StringSlice::size_type capacity) noexcept
+    {
+        return detail::utf8_transcode(slice, out, capacity);
+    }
+
+    /// Convert UTF-8 to UTF-32, validating the input in the same pass. Returns the number of codepoints written,
+    /// or StringSlice::npos on invalid input or a small output. utf8_length or slice.size() can size the output.
+    inline StringSlice::size_type transcode_utf8_to_utf32(const StringSlice& slice, char32_t* out,
+        StringSlice::size_type capacity) noexcept
+    {
+        return detail::utf8_transcode(slice, out, capacity);
+    }
+
+    /// Convert UTF-16 to UTF-8, validating surrogate pairs in the same pass. Returns the number of bytes written,
+    /// or StringSlice::npos if the input has an unpaired surrogate or the output is too small. The output is not
+    /// null terminated. Size the output with utf8_length_from_utf16, or use 3 bytes per code unit as an upper
+    /// bound.
+    inline StringSlice::size_type transcode_utf16_to_utf8(const char16_t* in, StringSlice::size_type count,
+        char* out, StringSlice::size_type capacity) noexcept
+    {
+        StringSlice::size_type i = 0;
+        StringSlice::size_type n = 0;
+
+        while (i < count)
+        {
+            // ASCII fast path, 4 units at a time.
+            if (i + 4 <= count && n + 4 <= capacity && ((in[i] | in[i + 1] | in[i + 2] | in[i + 3]) & 0xFF80) == 0)
+            {
+                out[n] = (char)in[i];
+                out[n + 1] = (char)in[i + 1];
+                out[n + 2] = (char)in[i + 2];
+                out[n + 3] = (char)in[i + 3];
+                i += 4;
+                n += 4;
+                continue;
+            }
+
+            uint32_t cp = in[i++];
+            if (cp >= 0xD800 && cp <= 0xDFFF)
+            {
+                if (cp > 0xDBFF || i == count || in[i] < 0xDC00 || in[i] > 0xDFFF)
+                {
+                    return StringSlice::npos;
+                }
+
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (in[i++] - 0xDC00);
+            }
+
+            unsigned int len = detail::utf8_encode(cp, out + n, capacity - n);
+            if (len == 0)
+            {
+                return StringSlice::npos;
+            }
+
+            n += len;
+        }
+
+        return n;
+    }
+
+    /// Convert UTF-32 to UTF-8. Returns the number of bytes written, or StringSlice::npos if the input has a
+    /// surrogate or a value above U+10FFFF, or the output is too small. The output is not null terminated.
+    inline StringSlice::size_type transcode_utf32_to_utf8(const char32_t* in, StringSlice::size_type count,
+        char* out, StringSlice::size_type capacity) noexcept
+    {
+        StringSlice::size_type n = 0;
+
+        for (StringSlice::size_type i = 0; i < count; ++i)
+        {
+            uint32_t cp = in[i];
+            if (cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF))
+            {
+                return StringSlice::npos;
+            }
+
+            unsigned int len = detail::utf8_encode(cp, out + n, capacity - n);
+            if (len == 0)
+            {
+                return StringSlice::npos;
+            }
+
+            n += len;
+        }
+
+        return n;
+    }
+}
+
+#endif // _SCOTTZ0R_UTF8_INCLUDE_GUARD
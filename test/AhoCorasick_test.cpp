@@ -0,0 +1,162 @@
+#include "catch.hpp"
+#include <vector>
+
+#include "AhoCorasick.h"
+
+namespace aho_corasick_tests
+{
+    using namespace scottz0r;
+
+    struct Match
+    {
+        StringSlice::size_type pattern;
+        StringSlice::size_type position;
+
+        bool operator==(const Match& other) const
+        {
+            return pattern == other.pattern && position == other.position;
+        }
+    };
+
+    static std::vector<Match> collect(const AhoCorasick& ac, const StringSlice& haystack)
+    {
+        std::vector<Match> matches;
+        ac.find_all(haystack, [&](StringSlice::size_type pattern, StringSlice::size_type position) {
+            matches.push_back({ pattern, position });
+        });
+        return matches;
+    }
+
+    TEST_CASE("AhoCorasick_Basic")
+    {
+        static char buffer[64 * 1024];
+        SliceArena arena(buffer);
+
+        SECTION("Classic example")
+        {
+            const StringSlice patterns[] = { "he", "she", "his", "hers" };
+            AhoCorasick ac;
+            REQUIRE(ac.build(patterns, arena));
+
+            std::vector<Match> matches = collect(ac, "ushers");
+            REQUIRE(matches.size() == 3);
+            REQUIRE(matches[0] == Match{ 1, 1 });
+            REQUIRE(matches[1] == Match{ 0, 2 });
+            REQUIRE(matches[2] == Match{ 3, 2 });
+
+            REQUIRE(ac.contains_any("this"));
+            REQUIRE_FALSE(ac.contains_any("xyz"));
+        }
+
+        SECTION("Empty and duplicate patterns")
+        {
+            const StringSlice patterns[] = { "", "ab", "ab", "b" };
+            AhoCorasick ac;
+            REQUIRE(ac.build(patterns, arena));
+
+            std::vector<Match> matches = collect(ac, "abab");
+            REQUIRE(matches.size() == 4);
+            REQUIRE(matches[0] == Match{ 1, 0 });
+            REQUIRE(matches[1] == Match{ 3, 1 });
+            REQUIRE(matches[2] == Match{ 1, 2 });
+            REQUIRE(matches[3] == Match{ 3, 3 });
+        }
+
+        SECTION("Arena too small")
+        {
+            char small[256];
+            SliceArena small_arena(small);
+            const StringSlice patterns[] = { "alpha", "beta", "gamma" };
+
+            AhoCorasick ac;
+            REQUIRE_FALSE(ac.build(patterns, small_arena));
+            REQUIRE(small_arena.mark() == 0);
+            REQUIRE(collect(ac, "alpha").empty());
+        }
+
+        SECTION("Temporary memory is released")
+        {
+            const StringSlice patterns[] = { "alpha", "beta", "gamma" };
+            AhoCorasick ac;
+            REQUIRE(ac.build(patterns, arena, 2));
+            size_t used = arena.mark();
+
+            AhoCorasick ac2;
+            REQUIRE(ac2.build(patterns, arena, 2));
+            REQUIRE(arena.mark() == used * 2);
+        }
+    }
+
+    TEST_CASE("AhoCorasick_Matches_Brute_Force")
+    {
+        // Patterns and text over a small alphabet, so there are many overlapping matches and deep failure chains.
+        std::vector<std::vector<char>> storage;
+        uint32_t seed = 99;
+        for (int i = 0; i < 300; ++i)
+        {
+            seed = seed * 1103515245 + 12345;
+            std::vector<char> p(1 + (seed >> 16) % 6);
+            for (char& c : p)
+            {
+                seed = seed * 1103515245 + 12345;
+                c = (char)('a' + (seed >> 16) % 4);
+            }
+            storage.push_back(p);
+        }
+
+        std::vector<StringSlice> patterns;
+        for (const auto& p : storage)
+        {
+            patterns.push_back(StringSlice(p.data(), (StringSlice::size_type)p.size()));
+        }
+
+        std::vector<char> text(5000);
+        for (char& c : text)
+        {
+            seed = seed * 1103515245 + 12345;
+            c = (char)('a' + (seed >> 16) % 5);
+        }
+        StringSlice haystack(text.data(), (StringSlice::size_type)text.size());
+
+        std::vector<char> buffer(4 << 20);
+        SliceArena arena(buffer.data(), buffer.size());
+
+        for (StringSlice::size_type dense : { 0u, 1u, 8u, 1000u })
+        {
+            AhoCorasick ac;
+            REQUIRE(ac.build(patterns.data(), (StringSlice::size_type)patterns.size(), arena, dense));
+
+            // Every reported match must be real, and the count must agree with a brute force scan.
+            unsigned int total = 0;
+            ac.find_all(haystack, [&](StringSlice::size_type pattern, StringSlice::size_type position) {
+                REQUIRE(haystack.substr(position, patterns[pattern].size()) == patterns[pattern]);
+                ++total;
+            });
+
+            // Duplicate patterns are only reported once.
+            std::vector<bool> first(patterns.size(), true);
+            for (size_t p = 0; p < patterns.size(); ++p)
+            {
+                for (size_t q = 0; q < p; ++q)
+                {
+                    first[p] = first[p] && !(patterns[q] == patterns[p]);
+                }
+            }
+
+            unsigned int expected = 0;
+            for (StringSlice::size_type i = 0; i < haystack.size(); ++i)
+            {
+                for (size_t p = 0; p < patterns.size(); ++p)
+                {
+                    if (first[p] && haystack.substr(i, patterns[p].size()) == patterns[p])
+                    {
+                        ++expected;
+                    }
+                }
+            }
+
+            REQUIRE(total == expected);
+            arena.reset();
+        }
+    }
+}
@@ -0,0 +1,149 @@
+#include "catch.hpp"
+
+#include "CsvReader.h"
+
+namespace csv_reader_tests
+{
+    using namespace scottz0r;
+
+    TEST_CASE("CsvReader_Rows")
+    {
+        SECTION("Simple rows")
+        {
+            CsvReader reader("a,b,c\n1,22,333\n");
+            CsvField fields[4];
+
+            REQUIRE(reader.read_row(fields) == 3);
+            REQUIRE(fields[0].value == "a");
+            REQUIRE(fields[1].value == "b");
+            REQUIRE(fields[2].value == "c");
+
+            REQUIRE(reader.read_row(fields) == 3);
+            REQUIRE(fields[0].value == "1");
+            REQUIRE(fields[1].value == "22");
+            REQUIRE(fields[2].value == "333");
+
+            REQUIRE(reader.at_end());
+            REQUIRE(reader.read_row(fields) == 0);
+        }
+
+        SECTION("No trailing newline and CRLF")
+        {
+            CsvReader reader("a,b\r\nc,d");
+            CsvField fields[4];
+
+            REQUIRE(reader.read_row(fields) == 2);
+            REQUIRE(fields[1].value == "b");
+
+            REQUIRE(reader.read_row(fields) == 2);
+            REQUIRE(fields[0].value == "c");
+            REQUIRE(fields[1].value == "d");
+            REQUIRE(reader.read_row(fields) == 0);
+        }
+
+        SECTION("Empty fields and empty line")
+        {
+            CsvReader reader(",,\n\nx");
+            CsvField fields[4];
+
+            REQUIRE(reader.read_row(fields) == 3);
+            REQUIRE(fields[0].value.empty());
+            REQUIRE(fields[2].value.empty());
+
+            REQUIRE(reader.read_row(fields) == 1);
+            REQUIRE(fields[0].value.empty());
+
+            REQUIRE(reader.read_row(fields) == 1);
+            REQUIRE(fields[0].value == "x");
+        }
+
+        SECTION("Too many fields")
+        {
+            CsvReader reader("a,b,c,d\ne");
+            CsvField fields[2];
+
+            REQUIRE(reader.read_row(fields) == 2);
+            REQUIRE(fields[1].value == "b");
+
+            REQUIRE(reader.read_row(fields) == 1);
+            REQUIRE(fields[0].value == "e");
+        }
+
+        SECTION("Tab delimiter")
+        {
+            CsvReader reader("a\tb,c\n", '\t');
+            CsvField fields[4];
+
+            REQUIRE(reader.read_row(fields) == 2);
+            REQUIRE(fields[1].value == "b,c");
+        }
+    }
+
+    TEST_CASE("CsvReader_Quotes")
+    {
+        SECTION("Quoted delimiters and newlines")
+        {
+            CsvReader reader("\"a,b\",\"line\nbreak\"\nnext");
+            CsvField fields[4];
+
+            REQUIRE(reader.read_row(fields) == 2);
+            REQUIRE(fields[0].quoted);
+            REQUIRE_FALSE(fields[0].needs_unescape);
+            REQUIRE(fields[0].value == "a,b");
+            REQUIRE(fields[1].value == "line\nbreak");
+
+            REQUIRE(reader.read_row(fields) == 1);
+            REQUIRE(fields[0].value == "next");
+        }
+
+        SECTION("Escaped quotes")
+        {
+            CsvReader reader("\"say \"\"hi\"\"\",x");
+            CsvField fields[4];
+
+            REQUIRE(reader.read_row(fields) == 2);
+            REQUIRE(fields[0].needs_unescape);
+            REQUIRE(fields[0].value == "say \"\"hi\"\"");
+
+            char buffer[32];
+            REQUIRE(fields[0].unescape_to(buffer) == 8);
+            REQUIRE(StringSlice(buffer) == "say \"hi\"");
+
+            char small[4];
+            REQUIRE(fields[0].unescape_to(small) == 3);
+            REQUIRE(StringSlice(small) == "say");
+        }
+
+        SECTION("Quotes spanning blocks")
+        {
+            // Build a row whose quoted field crosses several 64 byte blocks.
+            char data[300];
+            unsigned int n = 0;
+            data[n++] = '"';
+            for (int i = 0; i < 150; ++i)
+            {
+                data[n++] = (i % 10 == 0) ? ',' : 'x';
+            }
+            data[n++] = '"';
+            data[n++] = ',';
+            data[n++] = 'y';
+            data[n++] = '\n';
+            for (int i = 0; i < 100; ++i)
+            {
+                data[n++] = (i % 2 == 0) ? ',' : 'z';
+            }
+
+            CsvReader reader(StringSlice(data, n));
+            CsvField fields[64];
+
+            REQUIRE(reader.read_row(fields) == 2);
+            REQUIRE(fields[0].value.size() == 150);
+            REQUIRE(fields[1].value == "y");
+
+            REQUIRE(reader.read_row(fields) == 51);
+            REQUIRE(fields[1].value == "z");
+            REQUIRE(fields[0].value.empty());
+            REQUIRE(fields[50].value == "z");
+        }
+    }
+}
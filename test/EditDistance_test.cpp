@@ -0,0 +1,171 @@
+#include "catch.hpp"
+#include <random>
+#include <string>
+#include <vector>
+
+#include "EditDistance.h"
+#include "TestUtil.h"
+
+namespace edit_distance_tests
+{
+    using namespace scottz0r;
+    using namespace test_util;
+
+    /// Last row of the edit distance matrix of a against every prefix of b. In search mode a may start
+    /// anywhere in b.
+    static std::vector<size_t> naive_row(const std::string& a, const std::string& b, bool search)
+    {
+        std::vector<size_t> prev(b.size() + 1);
+        std::vector<size_t> cur(b.size() + 1);
+        for (size_t j = 0; j <= b.size(); ++j)
+        {
+            prev[j] = search ? 0 : j;
+        }
+
+        for (size_t i = 1; i <= a.size(); ++i)
+        {
+            cur[0] = i;
+            for (size_t j = 1; j <= b.size(); ++j)
+            {
+                size_t best = prev[j - 1] + (a[i - 1] == b[j - 1] ? 0 : 1);
+                best = prev[j] + 1 < best ? prev[j] + 1 : best;
+                best = cur[j - 1] + 1 < best ? cur[j - 1] + 1 : best;
+                cur[j] = best;
+            }
+            prev.swap(cur);
+        }
+
+        return prev;
+    }
+
+    static size_t naive_find(const std::string& haystack, const std::string& pattern, size_t k)
+    {
+        std::vector<size_t> row = naive_row(pattern, haystack, true);
+        for (size_t end = 0; end < row.size(); ++end)
+        {
+            if (row[end] <= k)
+            {
+                return end;
+            }
+        }
+        return StringSlice::npos;
+    }
+
+    TEST_CASE("EditDistance_Levenshtein")
+    {
+        REQUIRE(levenshtein("kitten", "sitting") == 3);
+        REQUIRE(levenshtein("sitting", "kitten") == 3);
+        REQUIRE(levenshtein("flaw", "lawn") == 2);
+        REQUIRE(levenshtein("", "abc") == 3);
+        REQUIRE(levenshtein("abc", "") == 3);
+        REQUIRE(levenshtein("", "") == 0);
+        REQUIRE(levenshtein("same", "same") == 0);
+
+        REQUIRE(levenshtein_bounded("kitten", "sitting", 3) == 3);
+        REQUIRE(levenshtein_bounded("kitten", "sitting", 2) == 3);
+        REQUIRE(levenshtein_bounded("kitten", "sitting", 0) == 1);
+        REQUIRE(levenshtein_bounded("a", "abcdef", 2) == 3);
+        REQUIRE(levenshtein_bounded("", "ab", 5) == 2);
+
+        // Effectively unbounded, without k + 1 wrapping around.
+        REQUIRE(levenshtein_bounded("kitten", "sitting", StringSlice::npos) == 3);
+        REQUIRE(levenshtein_bounded("kitten", "sitting", StringSlice::npos - 1) == 3);
+        REQUIRE(levenshtein_bounded("", "ab", StringSlice::npos) == 2);
+
+        // Longer than the 4096 byte limit on both sides.
+        std::string huge(5000, 'x');
+        REQUIRE(levenshtein(to_slice(huge), to_slice(huge)) == StringSlice::npos);
+        REQUIRE(levenshtein("x", to_slice(huge)) == 4999);
+        REQUIRE(levenshtein_bounded(to_slice(huge), to_slice(huge), 10) == StringSlice::npos);
+        REQUIRE(levenshtein_bounded(to_slice(huge), to_slice(huge.substr(0, 4097)), 10) == 11);
+    }
+
+    TEST_CASE("EditDistance_FuzzyFind")
+    {
+        StringSlice::size_type distance = 99;
+        REQUIRE(fuzzy_find("the quick brown fox", "quick", 0, &distance) == 9);
+        REQUIRE(distance == 0);
+        REQUIRE(fuzzy_find("the quikc brown fox", "quick", 0) == StringSlice::npos);
+        REQUIRE(fuzzy_find("the quikc brown fox", "quick", 1, &distance) == 8);
+        REQUIRE(distance == 1);
+        REQUIRE(fuzzy_find("the quikc brown fox", "quick", 2, &distance) == 7);
+        REQUIRE(distance == 2);
+        REQUIRE(fuzzy_find("the qick brown fox", "quick", 1, &distance) == 8);
+        REQUIRE(distance == 1);
+        REQUIRE(fuzzy_find("abc", "", 0) == 0);
+        REQUIRE(fuzzy_find("", "ab", 2) == 0);
+        REQUIRE(fuzzy_find("", "ab", 1) == StringSlice::npos);
+    }
+
+    TEST_CASE("EditDistance_BruteForce")
+    {
+        std::mt19937 rng(49);
+
+        // Lengths cross the 64 character block boundaries.
+        std::uniform_int_distribution<int> length(0, 200);
+        for (int round = 0; round < 300; ++round)
+        {
+            int alphabet = round % 2 == 0 ? 3 : 256;
+            std::uniform_int_distribution<int> letter(0, alphabet - 1);
+            std::string a;
+            std::string b;
+            for (int n = length(rng); n > 0; --n)
+            {
+                a += (char)(alphabet == 256 ? letter(rng) : 'a' + letter(rng));
+            }
+
+            // Mostly similar strings, so bounded distances are small.
+            b = a;
+            for (int edits = rng() % 12; edits > 0; --edits)
+            {
+                size_t pos = b.empty() ? 0 : rng() % b.size();
+                switch (rng() % 3)
+                {
+                case 0:
+                    b.insert(b.begin() + pos, (char)('a' + letter(rng) % 3));
+                    break;
+                case 1:
+                    if (!b.empty())
+                    {
+                        b.erase(b.begin() + pos);
+                    }
+                    break;
+                default:
+                    if (!b.empty())
+                    {
+                        b[pos] = (char)(b[pos] + 1);
+                    }
+                    break;
+                }
+            }
+
+            size_t expected = naive_row(a, b, false).back();
+            REQUIRE(levenshtein(to_slice(a), to_slice(b)) == expected);
+            for (size_t k = 0; k < 12; ++k)
+            {
+                REQUIRE(levenshtein_bounded(to_slice(a), to_slice(b), k) == (expected <= k ? expected : k + 1));
+            }
+        }
+
+        std::uniform_int_distribution<int> letter(0, 3);
+        for (int round = 0; round < 200; ++round)
+        {
+            std::string haystack;
+            for (int n = 1 + rng() % 150; n > 0; --n)
+            {
+                haystack += (char)('a' + letter(rng));
+            }
+
+            std::string pattern;
+            for (int n = 1 + rng() % (round % 2 == 0 ? 8 : 90); n > 0; --n)
+            {
+                pattern += (char)('a' + letter(rng));
+            }
+
+            for (size_t k = 0; k < 4; ++k)
+            {
+                REQUIRE(fuzzy_find(to_slice(haystack), to_slice(pattern), k) == naive_find(haystack, pattern, k));
+            }
+        }
+    }
+}
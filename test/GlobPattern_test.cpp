@@ -0,0 +1,188 @@
+#include "catch.hpp"
+#include <string>
+
+#include "GlobPattern.h"
+#include "TestUtil.h"
+
+namespace glob_pattern_tests
+{
+    using namespace scottz0r;
+    using namespace test_util;
+
+    // Straightforward backtracking matcher to compare against.
+    static bool reference_match(const char* p, const char* pend, const char* k, const char* kend)
+    {
+        while (p != pend)
+        {
+            if (*p == '*')
+            {
+                for (const char* s = k; s <= kend; ++s)
+                {
+                    if (reference_match(p + 1, pend, s, kend))
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            if (k == kend)
+            {
+                return false;
+            }
+
+            if (*p == '\\')
+            {
+                ++p;
+            }
+            else if (*p == '?')
+            {
+                ++p;
+                ++k;
+                continue;
+            }
+
+            if (*p != *k)
+            {
+                return false;
+            }
+
+            ++p;
+            ++k;
+        }
+
+        return k == kend;
+    }
+
+    TEST_CASE("GlobPattern_Match")
+    {
+        GlobPattern cpu("metrics.*.cpu");
+        REQUIRE(cpu.valid());
+        REQUIRE(cpu.matches("metrics.host1.cpu"));
+        REQUIRE(cpu.matches("metrics..cpu"));
+        REQUIRE(cpu.matches("metrics.a.cpu.b.cpu"));
+        REQUIRE_FALSE(cpu.matches("metrics.cpu"));
+        REQUIRE_FALSE(cpu.matches("metrics.host1.cpux"));
+        REQUIRE_FALSE(cpu.matches("xmetrics.host1.cpu"));
+
+        GlobPattern log("log-?\?-*.txt");
+        REQUIRE(log.matches("log-01-server.txt"));
+        REQUIRE(log.matches("log-ab-.txt"));
+        REQUIRE_FALSE(log.matches("log-1-server.txt"));
+        REQUIRE_FALSE(log.matches("log-01-server.txt.gz"));
+
+        GlobPattern middle("*a?c*x*");
+        REQUIRE(middle.matches("abcx"));
+        REQUIRE(middle.matches("zzabzazcqqx"));
+        REQUIRE_FALSE(middle.matches("abx"));
+
+        GlobPattern exact("abc");
+        REQUIRE(exact.matches("abc"));
+        REQUIRE_FALSE(exact.matches("abcd"));
+        REQUIRE_FALSE(exact.matches("ab"));
+
+        GlobPattern star("*");
+        REQUIRE(star.matches(""));
+        REQUIRE(star.matches("anything"));
+
+        GlobPattern empty("");
+        REQUIRE(empty.valid());
+        REQUIRE(empty.matches(""));
+        REQUIRE_FALSE(empty.matches("a"));
+    }
+
+    TEST_CASE("GlobPattern_Escapes")
+    {
+        GlobPattern escaped("a\\*b*\\?");
+        REQUIRE(escaped.valid());
+        REQUIRE(escaped.matches("a*b?"));
+        REQUIRE(escaped.matches("a*bxyz?"));
+        REQUIRE_FALSE(escaped.matches("axb?"));
+        REQUIRE_FALSE(escaped.matches("a*bx"));
+
+        GlobPattern backslash("x\\\\y");
+        REQUIRE(backslash.matches("x\\y"));
+
+        REQUIRE_FALSE(GlobPattern("abc\\").valid());
+        REQUIRE_FALSE(GlobPattern("abc\\").matches("abc"));
+    }
+
+    TEST_CASE("GlobPattern_Literals")
+    {
+        GlobPattern pattern("metrics.*.cpu");
+        REQUIRE(pattern.literal_prefix() == "metrics.");
+        REQUIRE(pattern.literal_suffix() == ".cpu");
+        REQUIRE(pattern.min_size() == 12);
+
+        GlobPattern literal("plain");
+        REQUIRE(literal.literal_prefix() == "plain");
+        REQUIRE(literal.literal_suffix() == "plain");
+
+        GlobPattern wild("?x*");
+        REQUIRE(wild.literal_prefix().empty());
+        REQUIRE(wild.literal_suffix().empty());
+    }
+
+    TEST_CASE("GlobPattern_Limits")
+    {
+        REQUIRE(GlobPattern("a*b*c*d*e*f*g*h*i*j*k*l*m*n*o*p").valid());
+        REQUIRE_FALSE(GlobPattern("a*b*c*d*e*f*g*h*i*j*k*l*m*n*o*p*q").valid());
+
+        // Repeated stars collapse and do not count against the limit.
+        REQUIRE(GlobPattern("a***************b").valid());
+
+        GlobPattern invalid;
+        REQUIRE_FALSE(invalid.valid());
+        REQUIRE_FALSE(invalid.matches(""));
+
+        // Pathological for backtracking matchers; this should be immediate.
+        std::string key(5000, 'a');
+        GlobPattern many("*a*a*a*a*a*a*a*a*a*b");
+        REQUIRE_FALSE(many.matches(to_slice(key)));
+    }
+
+    TEST_CASE("GlobPattern_BruteForce")
+    {
+        uint32_t seed = 987;
+        auto next = [&]() {
+            seed = seed * 1103515245 + 12345;
+            return (seed >> 16) & 0x7FFF;
+        };
+
+        const char pattern_chars[] = { 'a', 'b', '*', '?', '\\' };
+        for (int round = 0; round < 3000; ++round)
+        {
+            std::string pattern;
+            int plen = next() % 8;
+            for (int i = 0; i < plen; ++i)
+            {
+                pattern += pattern_chars[next() % 5];
+            }
+
+            std::string key;
+            int klen = next() % 12;
+            for (int i = 0; i < klen; ++i)
+            {
+                key += "ab*?\\"[next() % 5];
+            }
+
+            GlobPattern glob(to_slice(pattern));
+            bool trailing_escape = false;
+            for (char c : pattern)
+            {
+                trailing_escape = !trailing_escape && c == '\\';
+            }
+
+            REQUIRE(glob.valid() == !trailing_escape);
+            if (!glob.valid())
+            {
+                continue;
+            }
+
+            bool expected = reference_match(pattern.data(), pattern.data() + pattern.size(), key.data(),
+                key.data() + key.size());
+            INFO("pattern " << pattern << " key " << key);
+            REQUIRE(glob.matches(to_slice(key)) == expected);
+        }
+    }
+}
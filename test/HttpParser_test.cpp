@@ -0,0 +1,161 @@
+#include "catch.hpp"
+
+#include "HttpParser.h"
+
+namespace http_parser_tests
+{
+    using namespace scottz0r;
+
+    TEST_CASE("HttpParser_Request")
+    {
+        SECTION("Full request")
+        {
+            StringSlice buffer = "GET /index.html?q=1 HTTP/1.1\r\nHost: example.com\r\nX-Tab:\ta\tb \r\nEmpty:\r\n\r\nbody";
+            HttpRequest<8> req;
+
+            int n = parse_http_request(buffer, req);
+            REQUIRE(n == (int)buffer.size() - 4);
+            REQUIRE(req.method == "GET");
+            REQUIRE(req.path == "/index.html?q=1");
+            REQUIRE(req.minor_version == 1);
+            REQUIRE(req.num_headers == 3);
+            REQUIRE(req.headers[0].name == "Host");
+            REQUIRE(req.headers[0].value == "example.com");
+            REQUIRE(req.headers[1].value == "a\tb");
+            REQUIRE(req.headers[2].name == "Empty");
+            REQUIRE(req.headers[2].value.empty());
+        }
+
+        SECTION("Bare LF")
+        {
+            HttpRequest<2> req;
+            REQUIRE(parse_http_request("POST / HTTP/1.0\nA: b\n\n", req) == 22);
+            REQUIRE(req.minor_version == 0);
+            REQUIRE(req.headers[0].value == "b");
+        }
+
+        SECTION("Incomplete")
+        {
+            StringSlice full = "GET / HTTP/1.1\r\nHost: a\r\n\r\n";
+            HttpRequest<4> req;
+
+            for (StringSlice::size_type i = 0; i < full.size(); ++i)
+            {
+                REQUIRE(parse_http_request(full.substr(0, i), req) == http_parse_incomplete);
+            }
+
+            REQUIRE(parse_http_request(full, req) == (int)full.size());
+        }
+
+        SECTION("Incremental with last size")
+        {
+            StringSlice full = "GET / HTTP/1.1\r\nHost: a\r\n\r\n";
+            HttpRequest<4> req;
+
+            REQUIRE(parse_http_request(full.substr(0, 10), req) == http_parse_incomplete);
+            REQUIRE(parse_http_request(full.substr(0, 25), req, 10) == http_parse_incomplete);
+            REQUIRE(parse_http_request(full, req, 25) == (int)full.size());
+            REQUIRE(req.headers[0].name == "Host");
+        }
+
+        SECTION("Errors")
+        {
+            HttpRequest<1> req;
+            REQUIRE(parse_http_request("G(T / HTTP/1.1\r\n\r\n", req) == http_parse_error);
+            REQUIRE(parse_http_request("GET /a\x01 HTTP/1.1\r\n\r\n", req) == http_parse_error);
+            REQUIRE(parse_http_request("GET / HTTP/2.0\r\n\r\n", req) == http_parse_error);
+            REQUIRE(parse_http_request("GET / HTTP/1.1\r\nBad Name: x\r\n\r\n", req) == http_parse_error);
+            REQUIRE(parse_http_request("GET / HTTP/1.1\r\nA: x\x7f\r\n\r\n", req) == http_parse_error);
+            REQUIRE(parse_http_request("GET / HTTP/1.1\r\nA: 1\r\nB: 2\r\n\r\n", req) == http_parse_error);
+        }
+    }
+
+    TEST_CASE("HttpParser_Response")
+    {
+        SECTION("With reason")
+        {
+            StringSlice buffer = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n";
+            HttpResponse<4> res;
+
+            REQUIRE(parse_http_response(buffer, res) == (int)buffer.size());
+            REQUIRE(res.status == 404);
+            REQUIRE(res.reason == "Not Found");
+            REQUIRE(res.num_headers == 1);
+            REQUIRE(res.headers[0].value == "0");
+        }
+
+        SECTION("Without reason")
+        {
+            HttpResponse<4> res;
+            REQUIRE(parse_http_response("HTTP/1.0 200\r\n\r\n", res) == 16);
+            REQUIRE(res.status == 200);
+            REQUIRE(res.reason.empty());
+        }
+
+        SECTION("Errors")
+        {
+            HttpResponse<4> res;
+            REQUIRE(parse_http_response("HTTP/1.1 2x0 OK\r\n\r\n", res) == http_parse_error);
+            REQUIRE(parse_http_response("HTTP/1.1 200 OK\r\n", res) == http_parse_incomplete);
+        }
+    }
+
+    TEST_CASE("HttpChunkedDecoder")
+    {
+        SECTION("Whole body")
+        {
+            StringSlice input = "4\r\nWiki\r\n5;ext=1\r\npedia\r\n0\r\nTrailer: x\r\n\r\nNEXT";
+            HttpChunkedDecoder decoder;
+            char body[32];
+            unsigned int body_size = 0;
+
+            while (!decoder.done() && !decoder.error() && !input.empty())
+            {
+                StringSlice data;
+                auto n = decoder.decode(input, data);
+                body_size += data.copy_to(body + body_size, sizeof(body) - body_size);
+                input = input.substr(n);
+            }
+
+            REQUIRE(decoder.done());
+            REQUIRE(StringSlice(body, body_size) == "Wikipedia");
+            REQUIRE(input == "NEXT");
+        }
+
+        SECTION("One byte at a time")
+        {
+            StringSlice input = "A\r\n0123456789\r\n0\r\n\r\n";
+            HttpChunkedDecoder decoder;
+            char body[32];
+            unsigned int body_size = 0;
+
+            for (StringSlice::size_type i = 0; i < input.size(); ++i)
+            {
+                StringSlice data;
+                REQUIRE(decoder.decode(input.substr(i, 1), data) == 1);
+                body_size += data.copy_to(body + body_size, sizeof(body) - body_size);
+            }
+
+            REQUIRE(decoder.done());
+            REQUIRE(StringSlice(body, body_size) == "0123456789");
+        }
+
+        SECTION("Errors")
+        {
+            StringSlice data;
+
+            HttpChunkedDecoder bad_size;
+            bad_size.decode("xyz\r\n", data);
+            REQUIRE(bad_size.error());
+
+            HttpChunkedDecoder missing_crlf;
+            missing_crlf.decode("1\r\nab", data);
+            missing_crlf.decode("b", data);
+            REQUIRE(missing_crlf.error());
+
+            HttpChunkedDecoder overflow;
+            overflow.decode("fffffffff\r\n", data);
+            REQUIRE(overflow.error());
+        }
+    }
+}
@@ -0,0 +1,106 @@
+#include "catch.hpp"
+
+#include "JsonCursor.h"
+
+namespace json_cursor_tests
+{
+    using namespace scottz0r;
+
+    TEST_CASE("JsonCursor_Find")
+    {
+        const char* doc =
+            "{ \"type\": \"login\", \"user\": { \"name\": \"Bob \\\"B\\\"\", \"id\": 1234 },\n"
+            "  \"tags\": [\"a\", {\"x\": [1, 2]}, true], \"ok\" : null, \"empty\": {} }";
+
+        uint32_t tape[128];
+        JsonCursor cursor(doc, tape);
+        REQUIRE(cursor.valid());
+
+        SECTION("Top level")
+        {
+            REQUIRE(cursor.find("type") == "\"login\"");
+            REQUIRE(cursor.find("ok") == "null");
+            REQUIRE(cursor.find("empty") == "{}");
+        }
+
+        SECTION("Nested")
+        {
+            REQUIRE(cursor.find("user.id") == "1234");
+            REQUIRE(cursor.find("user.name") == "\"Bob \\\"B\\\"\"");
+            REQUIRE(cursor.find("user") == "{ \"name\": \"Bob \\\"B\\\"\", \"id\": 1234 }");
+        }
+
+        SECTION("Arrays")
+        {
+            REQUIRE(cursor.find("tags.0") == "\"a\"");
+            REQUIRE(cursor.find("tags.1.x") == "[1, 2]");
+            REQUIRE(cursor.find("tags.1.x.1") == "2");
+            REQUIRE(cursor.find("tags.2") == "true");
+        }
+
+        SECTION("Not found")
+        {
+            REQUIRE(cursor.find("missing").empty());
+            REQUIRE(cursor.find("user.id.x").empty());
+            REQUIRE(cursor.find("tags.3").empty());
+            REQUIRE(cursor.find("tags.x").empty());
+            REQUIRE(cursor.find("empty.a").empty());
+        }
+    }
+
+    TEST_CASE("JsonCursor_Index")
+    {
+        SECTION("Structural characters in strings are ignored")
+        {
+            uint32_t tape[16];
+            JsonCursor cursor("{\"a\":\"{[,:]}\\\\\",\"b\":2}", tape);
+            REQUIRE(cursor.valid());
+            REQUIRE(cursor.tape_size() == 11);
+            REQUIRE(cursor.find("b") == "2");
+        }
+
+        SECTION("Backslash runs across blocks")
+        {
+            // Place an escaped quote so the backslash run straddles the 64 byte block boundary.
+            char doc[160];
+            unsigned int n = 0;
+            const char prefix[] = "{\"k\":\"";
+            for (unsigned int i = 0; i < sizeof(prefix) - 1; ++i)
+            {
+                doc[n++] = prefix[i];
+            }
+            while (n < 63)
+            {
+                doc[n++] = 'x';
+            }
+            doc[n++] = '\\';
+            doc[n++] = '"';
+            const char suffix[] = "y\",\"z\":5}";
+            for (unsigned int i = 0; i < sizeof(suffix) - 1; ++i)
+            {
+                doc[n++] = suffix[i];
+            }
+
+            uint32_t tape[16];
+            JsonCursor cursor(StringSlice(doc, n), tape);
+            REQUIRE(cursor.valid());
+            REQUIRE(cursor.find("z") == "5");
+            REQUIRE(cursor.find("k").size() == n - 5 - 9 + 2);
+        }
+
+        SECTION("Tape too small")
+        {
+            uint32_t tape[4];
+            JsonCursor cursor("{\"a\":1,\"b\":2}", tape);
+            REQUIRE_FALSE(cursor.valid());
+            REQUIRE(cursor.find("a").empty());
+        }
+
+        SECTION("Unterminated string")
+        {
+            uint32_t tape[16];
+            JsonCursor cursor("{\"a\":\"abc}", tape);
+            REQUIRE_FALSE(cursor.valid());
+        }
+    }
+}
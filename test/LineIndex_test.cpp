@@ -0,0 +1,154 @@
+#include "catch.hpp"
+#include <type_traits>
+#include <vector>
+
+#include "LineIndex.h"
+
+namespace line_index_tests
+{
+    using namespace scottz0r;
+
+    template<typename Executor>
+    static void check_index(const StringSlice& slice, Executor& executor)
+    {
+        StringSlice::size_type newlines = parallel_count(slice, '\n', executor);
+        std::vector<uint32_t> deltas(LineIndex::deltas_needed(newlines));
+        std::vector<uint64_t> bases(LineIndex::bases_needed(newlines));
+
+        LineIndex index;
+        REQUIRE(index.build(slice, deltas.data(), (StringSlice::size_type)deltas.size(), bases.data(),
+            (StringSlice::size_type)bases.size(), executor));
+
+        // Walk the slice with get_line and compare every line.
+        StringSlice rest = slice;
+        StringSlice::size_type n = 0;
+        while (!rest.empty())
+        {
+            StringSlice expected = get_line(rest);
+            REQUIRE(index.line(n) == expected);
+            REQUIRE(index.line(n).data() == expected.data());
+            rest = rest.substr(expected.size());
+            ++n;
+        }
+
+        REQUIRE(index.size() == n);
+        REQUIRE(index.line(n).empty());
+    }
+
+    TEST_CASE("LineIndex_Small")
+    {
+        SerialExecutor serial;
+
+        SECTION("Trailing newline")
+        {
+            LineIndex index;
+            uint32_t deltas[4];
+            uint64_t bases[1];
+            REQUIRE(index.build("a\nbb\n\nccc\n", deltas, 4, bases, 1, serial) == false);
+
+            uint32_t more_deltas[5];
+            REQUIRE(index.build("a\nbb\n\nccc\n", more_deltas, 5, bases, 1, serial));
+            REQUIRE(index.size() == 4);
+            REQUIRE(index.line(0) == "a\n");
+            REQUIRE(index.line(1) == "bb\n");
+            REQUIRE(index.line(2) == "\n");
+            REQUIRE(index.line(3) == "ccc\n");
+            REQUIRE(index.line(4).empty());
+        }
+
+        SECTION("No trailing newline")
+        {
+            check_index(StringSlice("one\ntwo\nthree"), serial);
+        }
+
+        SECTION("Empty")
+        {
+            LineIndex index;
+            uint32_t deltas[1];
+            uint64_t bases[1];
+            REQUIRE(index.build(StringSlice(), deltas, 1, bases, 1, serial));
+            REQUIRE(index.size() == 0);
+        }
+    }
+
+    TEST_CASE("LineIndex_Large")
+    {
+        // Lines of varying length, including runs of empty lines and one long line, so blocks and chunk
+        // boundaries fall at many different places.
+        std::vector<char> data;
+        for (int i = 0; i < 40000; ++i)
+        {
+            int len = (i * 37) % 50;
+            if (i == 20000)
+            {
+                len = 300000;
+            }
+
+            for (int j = 0; j < len; ++j)
+            {
+                data.push_back((char)('a' + j % 26));
+            }
+
+            data.push_back('\n');
+        }
+
+        data.push_back('z');
+        StringSlice slice(data.data(), (StringSlice::size_type)data.size());
+
+        SerialExecutor serial;
+        ThreadPoolExecutor pool(4);
+        check_index(slice, serial);
+        check_index(slice, pool);
+    }
+
+    TEST_CASE("LineIndex_Slice64")
+    {
+        std::vector<char> data;
+        for (int i = 0; i < 1000; ++i)
+        {
+            for (int j = 0; j < i % 90; ++j)
+            {
+                data.push_back('x');
+            }
+            data.push_back('\n');
+        }
+
+        StringSlice64 slice(data.data(), data.size());
+        ThreadPoolExecutor pool(4);
+        uint64_t newlines = parallel_count(slice, '\n', pool);
+        std::vector<uint32_t> deltas(LineIndex64::deltas_needed(newlines));
+        std::vector<uint64_t> bases(LineIndex64::bases_needed(newlines));
+
+        LineIndex64 index;
+        REQUIRE(index.build(slice, deltas.data(), deltas.size(), bases.data(), bases.size(), pool));
+        REQUIRE(index.size() == 1000);
+
+        std::vector<uint64_t> offsets;
+        StringSlice64 rest = slice;
+        for (uint64_t n = 0; n < index.size(); ++n)
+        {
+            StringSlice64 expected = get_line(rest);
+            REQUIRE(index.line(n) == expected);
+            offsets.push_back((uint64_t)(expected.data() - data.data()));
+            REQUIRE(index.offset(n) == offsets.back());
+            rest = rest.substr(expected.size());
+        }
+        REQUIRE(index.offset(1000) == data.size());
+
+        // Offsets decode as 64-bit base plus 32-bit delta, so lines past 4 GiB keep their full offset. Synthesize a
+        // buffer that starts 20 GiB in by moving every base.
+        const uint64_t shift = 20ull << 30;
+        for (auto& base : bases)
+        {
+            base += shift;
+        }
+
+        auto first = index.offset(0);
+        static_assert(std::is_same<decltype(first), uint64_t>::value, "64-bit index gives 64-bit offsets");
+        for (uint64_t n = 0; n < index.size(); ++n)
+        {
+            REQUIRE(index.offset(n) == offsets[n] + shift);
+            REQUIRE(index.offset(n) > 0xFFFFFFFFull);
+        }
+    }
+}
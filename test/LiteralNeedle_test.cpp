@@ -0,0 +1,90 @@
+#include "catch.hpp"
+#include <string>
+
+#include "LiteralNeedle.h"
+#include "TestUtil.h"
+
+namespace literal_needle_tests
+{
+    using namespace scottz0r;
+    using namespace test_util;
+
+    TEST_CASE("LiteralNeedle_Anchors")
+    {
+        constexpr auto error = make_needle("ERROR");
+        static_assert(error.size == 5, "size excludes the null terminator");
+
+        // Upper case letters are rarer than lower case ones, and 'q' and 'z' are the rarest lower case letters.
+        constexpr auto mixed = make_needle("the quiz");
+        static_assert(mixed.chars[mixed.anchor] == 'z', "rarest byte is the anchor");
+        static_assert(mixed.chars[mixed.second_anchor] == 'q', "second rarest byte is the second anchor");
+
+        constexpr auto single = make_needle("x");
+        static_assert(single.anchor == 0 && single.second_anchor == 0, "single byte needle");
+
+        REQUIRE(error.slice() == "ERROR");
+    }
+
+    TEST_CASE("LiteralNeedle_Find")
+    {
+        constexpr auto needle = make_needle("ERROR");
+        StringSlice text = "INFO ok\nWARN ERR\nERROR failed\nERROR again";
+
+        REQUIRE(find(text, needle) == text.find("ERROR"));
+        REQUIRE(find(text, needle, 18) == text.find("ERROR", 18));
+        REQUIRE(find(text, needle, 31) == StringSlice::npos);
+        REQUIRE(find(text, needle, 1000) == StringSlice::npos);
+        REQUIRE(contains(text, needle));
+        REQUIRE_FALSE(contains("ERRO", needle));
+        REQUIRE_FALSE(contains("", needle));
+
+        // Needle at the very end, with the anchor not at the start of the needle.
+        constexpr auto tail = make_needle("a-Z");
+        REQUIRE(find("xxxxxxxxxxxxa-Z", tail) == 12);
+        REQUIRE(find("xxxxxxxxxxxxa-", tail) == StringSlice::npos);
+
+        constexpr auto empty = make_needle("");
+        REQUIRE(find("abc", empty) == 0);
+        REQUIRE(find("abc", empty, 3) == 3);
+        REQUIRE(find("abc", empty, 4) == StringSlice::npos);
+    }
+
+    TEST_CASE("LiteralNeedle_MatchesGenericFind")
+    {
+        constexpr auto n1 = make_needle("abab");
+        constexpr auto n2 = make_needle("b");
+        constexpr auto n3 = make_needle("aab ba");
+
+        uint32_t seed = 42;
+        for (int round = 0; round < 500; ++round)
+        {
+            std::string storage;
+            int len = (int)(seed % 80);
+            for (int i = 0; i < len; ++i)
+            {
+                seed = seed * 1103515245 + 12345;
+                storage += "ab "[(seed >> 16) % 3];
+            }
+            seed = seed * 1103515245 + 12345;
+
+            StringSlice text = to_slice(storage);
+            for (StringSlice::size_type start = 0; start <= text.size() + 1; ++start)
+            {
+                REQUIRE(find(text, n1, start) == text.find(n1.slice(), start));
+                REQUIRE(find(text, n2, start) == text.find(n2.slice(), start));
+                REQUIRE(find(text, n3, start) == text.find(n3.slice(), start));
+            }
+        }
+    }
+
+#if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L
+    TEST_CASE("LiteralNeedle_TemplateArgument")
+    {
+        StringSlice text = "GET /index.html HTTP/1.1";
+        REQUIRE(find<"HTTP/">(text) == 16);
+        REQUIRE(find<"/">(text, 5) == 20);
+        REQUIRE(contains<"index">(text));
+        REQUIRE_FALSE(contains<"POST">(text));
+    }
+#endif
+}
@@ -0,0 +1,176 @@
+#include "catch.hpp"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "LiteralSet.h"
+#include "TestUtil.h"
+
+namespace literal_set_tests
+{
+    using namespace scottz0r;
+    using namespace test_util;
+
+    struct Match
+    {
+        StringSlice::size_type pattern;
+        StringSlice::size_type position;
+
+        bool operator==(const Match& other) const
+        {
+            return pattern == other.pattern && position == other.position;
+        }
+    };
+
+    static std::vector<Match> collect(const LiteralSet& set, const StringSlice& haystack)
+    {
+        std::vector<Match> matches;
+        set.find_all(haystack, [&](StringSlice::size_type pattern, StringSlice::size_type position) {
+            matches.push_back({ pattern, position });
+        });
+        return matches;
+    }
+
+    static std::vector<Match> brute_force(const StringSlice* patterns, StringSlice::size_type count, const StringSlice& haystack)
+    {
+        std::vector<Match> matches;
+        for (StringSlice::size_type pos = 0; pos < haystack.size(); ++pos)
+        {
+            for (StringSlice::size_type p = 0; p < count; ++p)
+            {
+                if (haystack.substr(pos, patterns[p].size()) == patterns[p])
+                {
+                    matches.push_back({ p, pos });
+                }
+            }
+        }
+        return matches;
+    }
+
+    static void sort_matches(std::vector<Match>& matches)
+    {
+        std::sort(matches.begin(), matches.end(), [](const Match& a, const Match& b) {
+            return a.position != b.position ? a.position < b.position : a.pattern < b.pattern;
+        });
+    }
+
+    TEST_CASE("LiteralSet_Build")
+    {
+        LiteralSet set;
+        StringSlice::size_type pattern = 0;
+        REQUIRE(set.find("anything", pattern) == StringSlice::npos);
+
+        const StringSlice with_empty[] = { "a", "" };
+        REQUIRE_FALSE(set.build(with_empty));
+        REQUIRE_FALSE(set.build(with_empty, 0));
+
+        StringSlice too_many[LiteralSet::max_patterns + 1];
+        for (auto& p : too_many)
+        {
+            p = "x";
+        }
+        REQUIRE_FALSE(set.build(too_many));
+        REQUIRE(set.build(too_many, LiteralSet::max_patterns));
+    }
+
+    TEST_CASE("LiteralSet_Find")
+    {
+        const StringSlice patterns[] = { "ERROR", "WARN", "FATAL", "WARNING" };
+        LiteralSet set;
+        REQUIRE(set.build(patterns));
+
+        StringSlice text = "2024-01-01 INFO started\n2024-01-01 WARNING disk at 91%\n2024-01-01 ERROR write failed\n";
+        StringSlice::size_type pattern = 99;
+        StringSlice::size_type pos = set.find(text, pattern);
+        REQUIRE(pos == text.find("WARNING"));
+        REQUIRE(pattern == 1);
+
+        pos = set.find(text, pattern, pos + 1);
+        REQUIRE(pos == text.find("ERROR"));
+        REQUIRE(pattern == 0);
+
+        REQUIRE(set.find(text, pattern, pos + 1) == StringSlice::npos);
+        REQUIRE(set.find(text, pattern, text.size() + 10) == StringSlice::npos);
+        REQUIRE(set.find("WAR", pattern) == StringSlice::npos);
+
+        std::vector<Match> expected = { { 1, 35 }, { 3, 35 }, { 0, 66 } };
+        REQUIRE(collect(set, text) == expected);
+    }
+
+    TEST_CASE("LiteralSet_ShortPatterns")
+    {
+        // One byte patterns use a single fingerprint byte; matches at the very end must be found.
+        const StringSlice patterns[] = { "x", "yz", "zzz" };
+        LiteralSet set;
+        REQUIRE(set.build(patterns));
+
+        std::string storage(40, '.');
+        storage += "yzzzx";
+        StringSlice text = to_slice(storage);
+        std::vector<Match> matches = collect(set, text);
+        std::vector<Match> expected = brute_force(patterns, 3, text);
+        sort_matches(matches);
+        REQUIRE(matches == expected);
+        REQUIRE(matches.size() == 3);
+    }
+
+    TEST_CASE("LiteralSet_BruteForce")
+    {
+        // Random patterns over a small alphabet give many candidate hits and shared prefixes across buckets.
+        uint32_t seed = 12345;
+        auto next = [&]() {
+            seed = seed * 1103515245 + 12345;
+            return (seed >> 16) & 0x7FFF;
+        };
+
+        for (int round = 0; round < 20; ++round)
+        {
+            std::vector<std::string> storage;
+            StringSlice::size_type count = 2 + next() % (LiteralSet::max_patterns - 1);
+            for (StringSlice::size_type i = 0; i < count; ++i)
+            {
+                std::string p;
+                int len = 1 + next() % 6;
+                for (int j = 0; j < len; ++j)
+                {
+                    p += (char)('a' + next() % 4);
+                }
+                storage.push_back(p);
+            }
+
+            std::vector<StringSlice> patterns = to_slices(storage);
+
+            std::string text_storage;
+            int text_len = next() % 300;
+            for (int j = 0; j < text_len; ++j)
+            {
+                text_storage += (char)('a' + next() % 5);
+            }
+            StringSlice text = to_slice(text_storage);
+
+            LiteralSet set;
+            REQUIRE(set.build(patterns.data(), count));
+
+            std::vector<Match> matches = collect(set, text);
+            std::vector<Match> expected = brute_force(patterns.data(), count, text);
+            for (size_t i = 1; i < matches.size(); ++i)
+            {
+                REQUIRE(matches[i - 1].position <= matches[i].position);
+            }
+            sort_matches(matches);
+            REQUIRE(matches == expected);
+
+            StringSlice::size_type pattern = 0;
+            StringSlice::size_type pos = set.find(text, pattern);
+            if (expected.empty())
+            {
+                REQUIRE(pos == StringSlice::npos);
+            }
+            else
+            {
+                REQUIRE(pos == expected[0].position);
+                REQUIRE(pattern == expected[0].pattern);
+            }
+        }
+    }
+}
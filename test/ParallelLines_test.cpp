@@ -0,0 +1,183 @@
+#include "catch.hpp"
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "ParallelLines.h"
+
+namespace parallel_lines_tests
+{
+    using namespace scottz0r;
+
+    // Log-like buffer with lines of varying length, including empty lines and one very long line.
+    static std::vector<char> make_log(bool trailing_newline)
+    {
+        std::vector<char> data;
+        for (int i = 0; i < 30000; ++i)
+        {
+            const char* level = (i % 10 == 0) ? "ERROR " : "INFO ";
+            for (const char* p = level; *p; ++p)
+            {
+                data.push_back(*p);
+            }
+
+            int len = (i == 15000) ? 200000 : (i * 13) % 40;
+            for (int j = 0; j < len; ++j)
+            {
+                data.push_back('x');
+            }
+
+            data.push_back('\n');
+
+            if (i % 1000 == 0)
+            {
+                data.push_back('\n');
+            }
+        }
+
+        if (!trailing_newline)
+        {
+            data.push_back('e');
+        }
+
+        return data;
+    }
+
+    struct Stats
+    {
+        unsigned int lines = 0;
+        unsigned int errors = 0;
+        unsigned long long bytes = 0;
+    };
+
+    template<typename Executor>
+    static Stats count_stats(const StringSlice& slice, Executor& executor)
+    {
+        return reduce_lines_parallel(slice, Stats(),
+            [](Stats& acc, const StringSlice& line) {
+                ++acc.lines;
+                acc.bytes += line.size();
+                if (line.istarts_with("error"))
+                {
+                    ++acc.errors;
+                }
+            },
+            [](Stats& total, const Stats& acc) {
+                total.lines += acc.lines;
+                total.errors += acc.errors;
+                total.bytes += acc.bytes;
+            },
+            executor);
+    }
+
+    TEST_CASE("ParallelLines_Reduce")
+    {
+        SerialExecutor serial;
+        ThreadPoolExecutor pool(4);
+
+        for (int trailing = 0; trailing < 2; ++trailing)
+        {
+            std::vector<char> data = make_log(trailing != 0);
+            StringSlice slice(data.data(), (StringSlice::size_type)data.size());
+
+            Stats expected = count_stats(slice, serial);
+            REQUIRE(expected.lines == 30030u + (trailing ? 0u : 1u));
+            REQUIRE(expected.errors == 3000);
+            REQUIRE(expected.bytes == slice.size());
+
+            Stats parallel = count_stats(slice, pool);
+            REQUIRE(parallel.lines == expected.lines);
+            REQUIRE(parallel.errors == expected.errors);
+            REQUIRE(parallel.bytes == expected.bytes);
+        }
+    }
+
+    TEST_CASE("ParallelLines_For_Each")
+    {
+        std::vector<char> data = make_log(true);
+        StringSlice slice(data.data(), (StringSlice::size_type)data.size());
+        ThreadPoolExecutor pool(3);
+
+        // Every line must be seen once, starting right after a newline.
+        std::atomic<unsigned int> lines(0);
+        std::atomic<unsigned int> misaligned(0);
+        for_each_line_parallel(slice, [&](const StringSlice& line) {
+            ++lines;
+            if (line.data() != slice.data() && line.data()[-1] != '\n')
+            {
+                ++misaligned;
+            }
+            if (line[line.size() - 1] != '\n')
+            {
+                ++misaligned;
+            }
+        }, pool);
+
+        REQUIRE(lines.load() == slice.count('\n'));
+        REQUIRE(misaligned.load() == 0);
+
+        // An exception from fn reaches the caller instead of ending the process.
+        REQUIRE_THROWS_AS(for_each_line_parallel(slice, [&](const StringSlice& line) {
+            if (line.istarts_with("error"))
+            {
+                throw std::runtime_error("bad line");
+            }
+        }, pool), std::runtime_error);
+
+        REQUIRE_THROWS_AS(reduce_lines_parallel(slice, 0u,
+            [](unsigned int&, const StringSlice&) { throw std::runtime_error("bad line"); },
+            [](unsigned int& total, unsigned int acc) { total += acc; }, pool), std::runtime_error);
+    }
+
+    TEST_CASE("ParallelLines_Slice64")
+    {
+        std::vector<char> data = make_log(false);
+        StringSlice slice(data.data(), (StringSlice::size_type)data.size());
+        StringSlice64 slice64(data.data(), data.size());
+        SerialExecutor serial;
+        ThreadPoolExecutor pool(4);
+
+        Stats expected = count_stats(slice, serial);
+        uint64_t bytes = reduce_lines_parallel(slice64, (uint64_t)0,
+            [](uint64_t& acc, const StringSlice64& line) { acc += line.size(); },
+            [](uint64_t& total, uint64_t acc) { total += acc; }, pool);
+        REQUIRE(bytes == expected.bytes);
+
+        // Lines keep the 64-bit size type and line up with the 32-bit split.
+        std::atomic<unsigned int> lines(0);
+        std::atomic<unsigned int> misaligned(0);
+        for_each_line_parallel(slice64, [&](const StringSlice64& line) {
+            ++lines;
+            if (line.data() != slice64.data() && line.data()[-1] != '\n')
+            {
+                ++misaligned;
+            }
+        }, pool);
+
+        REQUIRE(lines.load() == expected.lines);
+        REQUIRE(misaligned.load() == 0);
+
+        detail::LineChunks<uint64_t> chunks(slice64, pool);
+        uint64_t covered = 0;
+        for (unsigned int i = 0; i < chunks.count(); ++i)
+        {
+            StringSlice64 chunk = chunks.chunk(i);
+            static_assert(std::is_same<decltype(chunk.size()), uint64_t>::value, "64-bit chunks");
+            REQUIRE(chunk.data() == slice64.data() + covered);
+            covered += chunk.size();
+        }
+        REQUIRE(covered == slice64.size());
+    }
+
+    TEST_CASE("ParallelLines_Small")
+    {
+        SerialExecutor serial;
+        unsigned int lines = 0;
+
+        for_each_line_parallel(StringSlice(), [&](const StringSlice&) { ++lines; }, serial);
+        REQUIRE(lines == 0);
+
+        for_each_line_parallel(StringSlice("a\n\nb"), [&](const StringSlice&) { ++lines; }, serial);
+        REQUIRE(lines == 3);
+    }
+}
@@ -0,0 +1,170 @@
+#include "catch.hpp"
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "ParallelScan.h"
+
+namespace parallel_scan_tests
+{
+    using namespace scottz0r;
+
+    // Buffer large enough to be split into many chunks.
+    static std::vector<char> make_buffer()
+    {
+        std::vector<char> data(1000003);
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+            data[i] = (i % 100 == 99) ? '\n' : (char)('a' + i % 7);
+        }
+
+        return data;
+    }
+
+    TEST_CASE("ParallelScan_Count")
+    {
+        std::vector<char> data = make_buffer();
+        StringSlice slice(data.data(), (StringSlice::size_type)data.size());
+
+        SerialExecutor serial;
+        ThreadPoolExecutor pool(4);
+
+        REQUIRE(parallel_count(slice, '\n', serial) == slice.count('\n'));
+        REQUIRE(parallel_count(slice, '\n', pool) == 10000);
+        REQUIRE(parallel_count(slice, 'z', pool) == 0);
+        REQUIRE(parallel_count(StringSlice(), 'z', pool) == 0);
+    }
+
+    TEST_CASE("ParallelScan_Find")
+    {
+        std::vector<char> data = make_buffer();
+        ThreadPoolExecutor pool(4);
+
+        SECTION("Single match near the end")
+        {
+            data[900000] = 'X';
+            data[900001] = 'Y';
+            StringSlice slice(data.data(), (StringSlice::size_type)data.size());
+
+            REQUIRE(parallel_find(slice, "XY", pool) == 900000);
+            REQUIRE(parallel_find(slice, 'X', pool) == 900000);
+            REQUIRE(parallel_find(slice, "XYZ", pool) == StringSlice::npos);
+        }
+
+        SECTION("First of many matches")
+        {
+            StringSlice slice(data.data(), (StringSlice::size_type)data.size());
+            REQUIRE(parallel_find(slice, "\na", pool) == slice.find("\na"));
+            REQUIRE(parallel_find(slice, 'g', pool) == 6);
+        }
+
+        SECTION("Match across a chunk boundary")
+        {
+            StringSlice slice(data.data(), (StringSlice::size_type)data.size());
+            detail::ParallelChunks chunks(slice, pool);
+            REQUIRE(chunks.count() > 1);
+
+            StringSlice::size_type boundary = chunks.begin(1);
+            data[boundary - 1] = 'P';
+            data[boundary] = 'Q';
+            REQUIRE(parallel_find(slice, "PQ", pool) == boundary - 1);
+        }
+    }
+
+    TEST_CASE("ParallelScan_Find_All")
+    {
+        std::vector<char> data = make_buffer();
+        StringSlice slice(data.data(), (StringSlice::size_type)data.size());
+        ThreadPoolExecutor pool(3);
+
+        SECTION("All matches in order")
+        {
+            std::vector<StringSlice::size_type> out(20000);
+            StringSlice::size_type n = parallel_find_all(slice, "\n", out.data(), (StringSlice::size_type)out.size(), pool);
+
+            REQUIRE(n == 10000);
+            for (StringSlice::size_type i = 0; i < n; ++i)
+            {
+                REQUIRE(out[i] == i * 100 + 99);
+            }
+        }
+
+        SECTION("Capacity smaller than matches")
+        {
+            StringSlice::size_type out[5];
+            REQUIRE(parallel_find_all(slice, "\n", out, 5, pool) == 10000);
+            REQUIRE(out[0] == 99);
+            REQUIRE(out[4] == 499);
+        }
+
+        SECTION("Overlapping matches")
+        {
+            SerialExecutor serial;
+            StringSlice::size_type out[8];
+            REQUIRE(parallel_find_all(StringSlice("aaaa"), "aa", out, 8, serial) == 3);
+            REQUIRE(out[2] == 2);
+        }
+    }
+
+    TEST_CASE("ParallelScan_Slice64")
+    {
+        std::vector<char> data = make_buffer();
+        StringSlice64 slice(data.data(), data.size());
+        ThreadPoolExecutor pool(4);
+
+        auto count = parallel_count(slice, '\n', pool);
+        static_assert(std::is_same<decltype(count), uint64_t>::value, "64-bit slices give 64-bit results");
+        REQUIRE(count == 10000);
+        REQUIRE(parallel_find(slice, "\na", pool) == slice.find("\na"));
+        REQUIRE(parallel_find(slice, 'g', pool) == 6);
+        REQUIRE(parallel_find(slice, "XYZ", pool) == StringSlice64::npos);
+
+        uint64_t out[5];
+        REQUIRE(parallel_find_all(slice, "\n", out, 5, pool) == 10000);
+        REQUIRE(out[4] == 499);
+
+        // Chunk boundaries of a 6 GiB slice are past 2^32. Only the size is used, so no memory is needed.
+        const uint64_t huge = 6ull << 30;
+        detail::ParallelChunks chunks(StringSlice64(data.data(), huge), pool);
+        REQUIRE(chunks.count() == 16);
+        REQUIRE(chunks.begin(0) == 0);
+        REQUIRE(chunks.end(chunks.count() - 1) == huge);
+        for (unsigned int i = 0; i < chunks.count(); ++i)
+        {
+            REQUIRE(chunks.end(i) - chunks.begin(i) >= huge / 16 - 1);
+            REQUIRE(chunks.end(i) - chunks.begin(i) <= huge / 16 + 1);
+        }
+    }
+
+    TEST_CASE("ThreadPoolExecutor_RunRethrow")
+    {
+        ThreadPoolExecutor pool(4);
+        std::atomic<unsigned int> calls(0);
+        REQUIRE_THROWS_AS(run_rethrow(pool, 64, [&](unsigned int i) {
+            ++calls;
+            if (i % 16 == 5)
+            {
+                throw std::runtime_error("task failed");
+            }
+        }), std::runtime_error);
+
+        // The other tasks still ran, and the pool is still usable.
+        REQUIRE(calls.load() == 64);
+        std::atomic<unsigned int> sum(0);
+        run_rethrow(pool, 100, [&](unsigned int i) { sum += i; });
+        REQUIRE(sum.load() == 4950);
+    }
+
+    TEST_CASE("ThreadPoolExecutor")
+    {
+        ThreadPoolExecutor pool(4);
+        REQUIRE(pool.concurrency() == 4);
+
+        for (int round = 0; round < 50; ++round)
+        {
+            std::atomic<unsigned int> sum(0);
+            pool.run(100, [&](unsigned int i) { sum += i; });
+            REQUIRE(sum.load() == 4950);
+        }
+    }
+}
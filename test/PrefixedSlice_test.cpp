@@ -0,0 +1,115 @@
+#include "catch.hpp"
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "PrefixedSlice.h"
+#include "TestUtil.h"
+
+namespace prefixed_slice_tests
+{
+    using namespace scottz0r;
+    using namespace test_util;
+
+    static int byte_compare(const std::string& a, const std::string& b)
+    {
+        size_t n = std::min(a.size(), b.size());
+        int c = memcmp(a.data(), b.data(), n);
+        if (c != 0)
+        {
+            return c < 0 ? -1 : 1;
+        }
+        return a.size() == b.size() ? 0 : (a.size() < b.size() ? -1 : 1);
+    }
+
+    TEST_CASE("PrefixedSlice_Storage")
+    {
+        PrefixedSlice empty;
+        REQUIRE(empty.empty());
+        REQUIRE(empty.is_inline());
+        REQUIRE(empty.slice() == "");
+
+        PrefixedSlice from_null(StringSlice(nullptr, 0));
+        REQUIRE(from_null.empty());
+        REQUIRE(from_null == empty);
+
+        const char* short_text = "hello world!";
+        PrefixedSlice small(short_text);
+        REQUIRE(small.is_inline());
+        REQUIRE(small.size() == 12);
+        REQUIRE(small.slice() == "hello world!");
+        REQUIRE(small.data() != short_text);
+        REQUIRE((const void*)small.data() > (const void*)&small);
+        REQUIRE((const void*)(small.data() + small.size()) <= (const void*)(&small + 1));
+
+        const char* long_text = "hello world!!";
+        PrefixedSlice large(long_text);
+        REQUIRE_FALSE(large.is_inline());
+        REQUIRE(large.data() == long_text);
+        REQUIRE(large.slice() == "hello world!!");
+
+        // Copies of inline strings point at their own storage.
+        PrefixedSlice copy = small;
+        REQUIRE(copy.data() != small.data());
+        REQUIRE(copy.slice() == small.slice());
+    }
+
+    TEST_CASE("PrefixedSlice_Compare")
+    {
+        REQUIRE(PrefixedSlice("abc") == PrefixedSlice("abc"));
+        REQUIRE(PrefixedSlice("abc") != PrefixedSlice("abd"));
+        REQUIRE(PrefixedSlice("abc") < PrefixedSlice("abd"));
+        REQUIRE(PrefixedSlice("ab") < PrefixedSlice("abc"));
+        REQUIRE(PrefixedSlice(StringSlice("ab\0", 3)) > PrefixedSlice("ab"));
+        REQUIRE(PrefixedSlice("abcdefghijklmnop") > PrefixedSlice("abcdefghijkl"));
+        REQUIRE(PrefixedSlice("abcdefghijklmnop") < PrefixedSlice("abcdefghijklmnoq"));
+        REQUIRE(PrefixedSlice("abcdefghijklmnop") == PrefixedSlice(std::string("abcdefghijklmnop").c_str()));
+        REQUIRE(PrefixedSlice("\xFF") > PrefixedSlice("a"));
+        REQUIRE(PrefixedSlice("b") >= PrefixedSlice("a"));
+        REQUIRE(PrefixedSlice("a") <= PrefixedSlice("a"));
+    }
+
+    TEST_CASE("PrefixedSlice_MatchesByteOrder")
+    {
+        // Short strings over a tiny alphabet, so many share prefixes and cross the inline size limit.
+        uint32_t seed = 7;
+        std::vector<std::string> strings;
+        for (int i = 0; i < 400; ++i)
+        {
+            seed = seed * 1103515245 + 12345;
+            int len = (seed >> 16) % 18;
+            std::string s;
+            for (int j = 0; j < len; ++j)
+            {
+                seed = seed * 1103515245 + 12345;
+                s += "a\x80\0"[(seed >> 16) % 3];
+            }
+            strings.push_back(s);
+        }
+
+        std::vector<PrefixedSlice> slices;
+        for (const auto& s : strings)
+        {
+            slices.push_back(PrefixedSlice(to_slice(s)));
+        }
+
+        for (size_t i = 0; i < strings.size(); i += 3)
+        {
+            for (size_t j = 0; j < strings.size(); ++j)
+            {
+                REQUIRE(slices[i].compare(slices[j]) == byte_compare(strings[i], strings[j]));
+                REQUIRE((slices[i] == slices[j]) == (strings[i] == strings[j]));
+            }
+        }
+
+        // Sort a copy; long slices point into the original strings.
+        std::vector<std::string> sorted = strings;
+        std::sort(slices.begin(), slices.end());
+        std::sort(sorted.begin(), sorted.end());
+        for (size_t i = 0; i < sorted.size(); ++i)
+        {
+            REQUIRE(slices[i].slice() == to_slice(sorted[i]));
+        }
+    }
+}
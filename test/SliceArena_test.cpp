@@ -0,0 +1,52 @@
+#include "catch.hpp"
+
+#include "SliceArena.h"
+
+namespace slice_arena_tests
+{
+    using namespace scottz0r;
+
+    TEST_CASE("SliceArena")
+    {
+        alignas(8) char buffer[64];
+        SliceArena arena(buffer);
+
+        SECTION("Alignment and capacity")
+        {
+            char* c = arena.allocate<char>(3);
+            uint32_t* u = arena.allocate<uint32_t>(2);
+            uint64_t* w = arena.allocate<uint64_t>(1);
+
+            REQUIRE(c == buffer);
+            REQUIRE((uintptr_t)u % alignof(uint32_t) == 0);
+            REQUIRE((char*)u == buffer + 4);
+            REQUIRE((char*)w == buffer + 16);
+            REQUIRE(arena.mark() == 24);
+
+            REQUIRE(arena.allocate<uint64_t>(6) == nullptr);
+            REQUIRE(arena.allocate<uint64_t>(6) == nullptr);
+            REQUIRE(arena.allocate<uint64_t>(4) != nullptr);
+            REQUIRE(arena.available() == 8);
+        }
+
+        SECTION("Mark and release")
+        {
+            arena.allocate<char>(10);
+            size_t mark = arena.mark();
+            arena.allocate<char>(20);
+            arena.release(mark);
+            REQUIRE(arena.mark() == 10);
+
+            arena.reset();
+            REQUIRE(arena.mark() == 0);
+            REQUIRE(arena.capacity() == 64);
+        }
+
+        SECTION("Null buffer")
+        {
+            SliceArena empty(nullptr, 100);
+            REQUIRE(empty.capacity() == 0);
+            REQUIRE(empty.allocate<char>(1) == nullptr);
+        }
+    }
+}
@@ -0,0 +1,46 @@
+#include "catch.hpp"
+#include <random>
+
+#include "SliceBits.h"
+
+namespace slice_bits_tests
+{
+    using namespace scottz0r;
+
+    TEST_CASE("SliceBits_ByteBlock")
+    {
+        std::mt19937 rng(26);
+        char buffer[bits::block_size];
+
+        for (unsigned int len = 0; len <= bits::block_size; ++len)
+        {
+            for (unsigned int i = 0; i < bits::block_size; ++i)
+            {
+                // Small alphabet including 0, which matches the padding of short blocks.
+                buffer[i] = "\0a,\"\xFF"[rng() % 5];
+            }
+
+            bits::ByteBlock block(buffer, len);
+            REQUIRE(block.valid() == (len == bits::block_size ? ~0ull : (1ull << len) - 1));
+
+            for (char c : { '\0', 'a', ',', '"', '\xFF', 'z' })
+            {
+                uint64_t expected = 0;
+                for (unsigned int i = 0; i < len; ++i)
+                {
+                    expected |= (uint64_t)(buffer[i] == c) << i;
+                }
+
+                REQUIRE(block.eq(c) == expected);
+                REQUIRE(bits::eq_mask(buffer, len, c) == expected);
+            }
+        }
+    }
+
+    TEST_CASE("SliceBits_LoadLittleEndian")
+    {
+        const char bytes[] = { 1, 2, 3, 4, 5, 6, 7, (char)0x88 };
+        REQUIRE(bits::load_le_u64(bytes) == 0x8807060504030201ull);
+        REQUIRE(bits::gather_high_bits(0x8000000000800080ull) == 0x85);
+    }
+}
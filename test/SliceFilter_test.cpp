@@ -0,0 +1,180 @@
+#include "catch.hpp"
+#include <string>
+#include <vector>
+
+#include "SliceFilter.h"
+#include "TestUtil.h"
+
+namespace slice_filter_tests
+{
+    using namespace scottz0r;
+    using namespace test_util;
+
+    static std::vector<std::string> make_keys(const char* prefix, int count)
+    {
+        std::vector<std::string> keys;
+        for (int i = 0; i < count; ++i)
+        {
+            keys.push_back(prefix + std::to_string(i));
+        }
+        return keys;
+    }
+
+    TEST_CASE("BlockedBloomFilter_Basic")
+    {
+        std::vector<std::string> keys = make_keys("user:", 10000);
+        std::vector<uint64_t> storage(BlockedBloomFilter::storage_words(keys.size()));
+        BlockedBloomFilter filter(storage.data(), storage.size());
+        REQUIRE(filter.valid());
+        REQUIRE(filter.writable());
+        REQUIRE(filter.block_count() == (storage.size() - 8) / 8);
+        REQUIRE_FALSE(filter.possibly_contains("user:1"));
+
+        for (const auto& key : keys)
+        {
+            REQUIRE(filter.add(to_slice(key)));
+        }
+
+        for (const auto& key : keys)
+        {
+            REQUIRE(filter.possibly_contains(to_slice(key)));
+        }
+
+        int false_positives = 0;
+        for (const auto& key : make_keys("other:", 10000))
+        {
+            false_positives += filter.possibly_contains(to_slice(key)) ? 1 : 0;
+        }
+        REQUIRE(false_positives < 300);
+
+        REQUIRE(filter.possibly_contains_hash(StringSlice("user:42").hash()));
+    }
+
+    TEST_CASE("BlockedBloomFilter_Load")
+    {
+        uint64_t storage[8 + 64];
+        BlockedBloomFilter filter(storage);
+        REQUIRE(filter.add("alpha"));
+        REQUIRE(filter.add("beta"));
+        REQUIRE(filter.size_bytes() == sizeof(storage));
+
+        // Serialize and load the copy, as from a file.
+        std::vector<uint64_t> copy(filter.size_bytes() / sizeof(uint64_t));
+        memcpy(copy.data(), filter.data(), filter.size_bytes());
+
+        BlockedBloomFilter loaded;
+        REQUIRE(loaded.load(copy.data(), copy.size() * sizeof(uint64_t)));
+        REQUIRE(loaded.valid());
+        REQUIRE_FALSE(loaded.writable());
+        REQUIRE(loaded.possibly_contains("alpha"));
+        REQUIRE(loaded.possibly_contains("beta"));
+        REQUIRE_FALSE(loaded.add("gamma"));
+        REQUIRE(loaded.block_count() == 8);
+
+        REQUIRE_FALSE(loaded.load(copy.data(), copy.size() * sizeof(uint64_t) - 8));
+        REQUIRE_FALSE(loaded.valid());
+        REQUIRE_FALSE(loaded.load((const char*)copy.data() + 1, 64));
+        copy[0] = 0;
+        REQUIRE_FALSE(loaded.load(copy.data(), copy.size() * sizeof(uint64_t)));
+
+        uint64_t tiny[12];
+        BlockedBloomFilter too_small(tiny);
+        REQUIRE_FALSE(too_small.valid());
+        REQUIRE_FALSE(too_small.add("a"));
+    }
+
+    TEST_CASE("XorFilter_Basic")
+    {
+        std::vector<std::string> keys = make_keys("doc/", 20000);
+        std::vector<StringSlice> slices;
+        for (const auto& key : keys)
+        {
+            slices.push_back(to_slice(key));
+        }
+
+        // Repeated keys are fine.
+        slices.push_back(slices[0]);
+        slices.push_back(slices[1]);
+
+        std::vector<char> buffer(2 * 1024 * 1024);
+        SliceArena arena(buffer.data(), buffer.size());
+        XorFilter filter;
+        REQUIRE_FALSE(filter.valid());
+        REQUIRE_FALSE(filter.possibly_contains("doc/1"));
+
+        REQUIRE(filter.build(slices.data(), slices.size(), arena));
+        REQUIRE(filter.valid());
+
+        // Only the filter stays in the arena, at about 1.23 bytes per key.
+        REQUIRE(arena.mark() == filter.size_bytes());
+        REQUIRE(filter.size_bytes() < keys.size() * 13 / 10);
+
+        for (const auto& key : keys)
+        {
+            REQUIRE(filter.possibly_contains(to_slice(key)));
+        }
+
+        int false_positives = 0;
+        for (const auto& key : make_keys("missing/", 20000))
+        {
+            false_positives += filter.possibly_contains(to_slice(key)) ? 1 : 0;
+        }
+        REQUIRE(false_positives < 200);
+
+        std::vector<uint64_t> copy(filter.size_bytes() / sizeof(uint64_t));
+        memcpy(copy.data(), filter.data(), filter.size_bytes());
+        XorFilter loaded;
+        REQUIRE(loaded.load(copy.data(), filter.size_bytes()));
+        for (size_t i = 0; i < keys.size(); i += 97)
+        {
+            REQUIRE(loaded.possibly_contains(to_slice(keys[i])));
+        }
+
+        REQUIRE_FALSE(loaded.load(copy.data(), filter.size_bytes() - 8));
+        REQUIRE_FALSE(loaded.valid());
+
+        // A bloom filter is not an xor filter.
+        uint64_t bloom_storage[16];
+        BlockedBloomFilter bloom(bloom_storage);
+        REQUIRE_FALSE(loaded.load(bloom.data(), bloom.size_bytes()));
+    }
+
+    TEST_CASE("XorFilter_Build")
+    {
+        char buffer[4096];
+        SliceArena arena(buffer);
+        XorFilter filter;
+
+        REQUIRE(filter.build(nullptr, 0, arena));
+        REQUIRE(filter.valid());
+        REQUIRE_FALSE(filter.possibly_contains("a"));
+
+        arena.reset();
+        StringSlice keys[] = { "a", "b", "c" };
+        REQUIRE(filter.build(keys, arena));
+        REQUIRE(filter.possibly_contains("a"));
+        REQUIRE(filter.possibly_contains("b"));
+        REQUIRE(filter.possibly_contains("c"));
+
+        uint64_t hashes[] = { 1, 2, 3, 3, 4 };
+        arena.reset();
+        REQUIRE(filter.build_hashes(hashes, 5, arena));
+        for (uint64_t h : hashes)
+        {
+            REQUIRE(filter.possibly_contains_hash(h));
+        }
+
+        // Too many keys for the arena.
+        std::vector<std::string> many = make_keys("k", 1000);
+        std::vector<StringSlice> slices;
+        for (const auto& key : many)
+        {
+            slices.push_back(to_slice(key));
+        }
+
+        arena.reset();
+        REQUIRE_FALSE(filter.build(slices.data(), slices.size(), arena));
+        REQUIRE_FALSE(filter.valid());
+        REQUIRE(arena.mark() == 0);
+    }
+}
@@ -0,0 +1,77 @@
+#include "catch.hpp"
+#include <map>
+#include <string>
+#include <vector>
+
+#include "SliceFrequency.h"
+#include "TestUtil.h"
+
+namespace slice_frequency_tests
+{
+    using namespace scottz0r;
+    using namespace test_util;
+
+    static std::map<std::string, size_t> to_map(const std::vector<SliceCount>& counts)
+    {
+        std::map<std::string, size_t> map;
+        for (const auto& c : counts)
+        {
+            REQUIRE(map.count(std::string(c.slice.data(), c.slice.size())) == 0);
+            map[std::string(c.slice.data(), c.slice.size())] = c.count;
+        }
+        return map;
+    }
+
+    TEST_CASE("SliceFrequency_Small")
+    {
+        StringSlice words[] = { "error", "warn", "error", "", "info", "error", "", "warn" };
+        SerialExecutor executor;
+
+        std::vector<SliceCount> counts = frequency_table(words, words + 8, executor);
+        REQUIRE(counts.size() == 4);
+        REQUIRE(count_distinct(words, words + 8, executor) == 4);
+
+        std::map<std::string, size_t> map = to_map(counts);
+        REQUIRE(map["error"] == 3);
+        REQUIRE(map["warn"] == 2);
+        REQUIRE(map["info"] == 1);
+        REQUIRE(map[""] == 2);
+
+        // Slices point at the input, not copies.
+        for (const auto& c : counts)
+        {
+            if (c.slice == "error")
+            {
+                REQUIRE(c.slice.data() == words[0].data());
+            }
+        }
+
+        REQUIRE(frequency_table(words, words, executor).empty());
+        REQUIRE(count_distinct(words, words, executor) == 0);
+    }
+
+    TEST_CASE("SliceFrequency_Parallel")
+    {
+        // Enough keys to use several chunks and partitions.
+        std::vector<std::string> storage;
+        std::map<std::string, size_t> expected;
+        uint32_t seed = 99;
+        for (int i = 0; i < 200000; ++i)
+        {
+            seed = seed * 1103515245 + 12345;
+            std::string key = "message " + std::to_string((seed >> 16) % 5000);
+            storage.push_back(key);
+            ++expected[key];
+        }
+
+        std::vector<StringSlice> slices = to_slices(storage);
+
+        ThreadPoolExecutor pool(4);
+        SerialExecutor serial;
+
+        std::vector<SliceCount> counts = frequency_table(slices.data(), slices.data() + slices.size(), pool);
+        REQUIRE(to_map(counts) == expected);
+        REQUIRE(count_distinct(slices.data(), slices.data() + slices.size(), pool) == expected.size());
+        REQUIRE(to_map(frequency_table(slices.data(), slices.data() + slices.size(), serial)) == expected);
+    }
+}
@@ -0,0 +1,141 @@
+#include "catch.hpp"
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "SliceHashMap.h"
+#include "TestUtil.h"
+
+namespace slice_hash_map_tests
+{
+    using namespace scottz0r;
+    using namespace test_util;
+
+    TEST_CASE("SliceHashMap_Basic")
+    {
+        SliceHashMap<int> none;
+        REQUIRE_FALSE(none.valid());
+        REQUIRE_FALSE(none.insert("a", 1));
+        REQUIRE(none.find("a") == nullptr);
+
+        char buffer[4096];
+        SliceArena arena(buffer);
+        SliceHashMap<int> map(arena, 4);
+        REQUIRE(map.valid());
+        REQUIRE(map.empty());
+        REQUIRE(map.max_size() == 4);
+
+        // Keys are copied, so the caller's string can go away.
+        {
+            std::string temp = "GET";
+            REQUIRE(map.insert(to_slice(temp), 1));
+        }
+        REQUIRE(map.insert("POST", 2));
+        REQUIRE(map.insert("", 3));
+        REQUIRE(map.insert("PUT", 4));
+        REQUIRE(map.size() == 4);
+
+        // Full, but replacing a value still works.
+        REQUIRE_FALSE(map.insert("DELETE", 5));
+        REQUIRE(map.insert("POST", 20));
+        REQUIRE(map.size() == 4);
+
+        REQUIRE(*map.find("GET") == 1);
+        REQUIRE(*map.find("POST") == 20);
+        REQUIRE(*map.find("") == 3);
+        REQUIRE(map.contains("PUT"));
+        REQUIRE_FALSE(map.contains("DELETE"));
+        REQUIRE_FALSE(map.contains("GE"));
+
+        *map.find("PUT") = 40;
+        REQUIRE(*map.find("PUT") == 40);
+
+        StringSlice keys[] = { "PUT", "HEAD", "GET", "" };
+        const int* out[4];
+        REQUIRE(map.lookup_batch(keys, out) == 3);
+        REQUIRE(*out[0] == 40);
+        REQUIRE(out[1] == nullptr);
+        REQUIRE(*out[2] == 1);
+        REQUIRE(*out[3] == 3);
+
+        REQUIRE(none.lookup_batch(keys, out) == 0);
+        REQUIRE(out[0] == nullptr);
+
+        // Too small for the slots.
+        char tiny[16];
+        SliceArena tiny_arena(tiny);
+        SliceHashMap<int> small(tiny_arena, 100);
+        REQUIRE_FALSE(small.valid());
+        REQUIRE(tiny_arena.mark() == 0);
+    }
+
+    TEST_CASE("SliceHashMap_BruteForce")
+    {
+        std::mt19937 rng(50);
+        std::uniform_int_distribution<int> length(0, 12);
+        std::uniform_int_distribution<int> letter(0, 3);
+
+        std::vector<std::string> strings;
+        for (int i = 0; i < 5000; ++i)
+        {
+            std::string s;
+            for (int n = length(rng); n > 0; --n)
+            {
+                s += (char)("abc\xE9"[letter(rng)]);
+            }
+            strings.push_back(s);
+        }
+
+        std::vector<char> buffer(1 << 20);
+        SliceArena arena(buffer.data(), buffer.size());
+        SliceHashMap<uint32_t> map(arena, 3000);
+        REQUIRE(map.valid());
+
+        std::unordered_map<std::string, uint32_t> expected;
+        for (uint32_t i = 0; i < 2500; ++i)
+        {
+            const std::string& key = strings[i];
+            REQUIRE(map.insert(to_slice(key), i));
+            expected[key] = i;
+        }
+        REQUIRE(map.size() == expected.size());
+
+        // Every string, half of them missing, in batches that do not line up with the prefetch groups.
+        std::vector<StringSlice> keys;
+        for (const auto& s : strings)
+        {
+            keys.push_back(to_slice(s));
+        }
+
+        std::vector<const uint32_t*> out(keys.size());
+        size_t offset = 0;
+        size_t found = 0;
+        while (offset < keys.size())
+        {
+            size_t n = 1 + rng() % 40;
+            n = n < keys.size() - offset ? n : keys.size() - offset;
+            found += map.lookup_batch(keys.data() + offset, n, out.data() + offset);
+            offset += n;
+        }
+
+        size_t expected_found = 0;
+        for (size_t i = 0; i < strings.size(); ++i)
+        {
+            auto it = expected.find(strings[i]);
+            if (it == expected.end())
+            {
+                REQUIRE(out[i] == nullptr);
+                REQUIRE(map.find(keys[i]) == nullptr);
+            }
+            else
+            {
+                REQUIRE(out[i] != nullptr);
+                REQUIRE(*out[i] == it->second);
+                REQUIRE(out[i] == map.find(keys[i]));
+                ++expected_found;
+            }
+        }
+        REQUIRE(found == expected_found);
+    }
+}
@@ -0,0 +1,124 @@
+#include "catch.hpp"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "SliceSort.h"
+#include "TestUtil.h"
+
+namespace slice_sort_tests
+{
+    using namespace scottz0r;
+    using namespace test_util;
+
+    static std::vector<std::string> random_keys(size_t count, uint32_t seed, const char* alphabet, int max_len)
+    {
+        size_t letters = strlen(alphabet);
+        std::vector<std::string> keys;
+        keys.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            seed = seed * 1103515245 + 12345;
+            int len = (int)((seed >> 16) % (max_len + 1));
+            std::string key;
+            for (int j = 0; j < len; ++j)
+            {
+                seed = seed * 1103515245 + 12345;
+                key += alphabet[(seed >> 16) % letters];
+            }
+            keys.push_back(key);
+        }
+        return keys;
+    }
+
+    static void require_matches_std_sort(const std::vector<std::string>& keys)
+    {
+        std::vector<StringSlice> sorted = to_slices(keys);
+        std::vector<StringSlice> expected = sorted;
+        sort_slices(sorted.data(), sorted.data() + sorted.size());
+        std::sort(expected.begin(), expected.end());
+
+        REQUIRE(sorted.size() == expected.size());
+        for (size_t i = 0; i < sorted.size(); ++i)
+        {
+            REQUIRE(sorted[i] == expected[i]);
+        }
+    }
+
+    TEST_CASE("SliceSort_Small")
+    {
+        std::vector<StringSlice> empty;
+        sort_slices(empty.data(), empty.data());
+
+        StringSlice words[] = { "pear", "apple", "", "fig", "apple", "app", "banana" };
+        sort_slices(words, words + 7);
+        REQUIRE(words[0] == "");
+        REQUIRE(words[1] == "app");
+        REQUIRE(words[2] == "apple");
+        REQUIRE(words[3] == "apple");
+        REQUIRE(words[4] == "banana");
+        REQUIRE(words[5] == "fig");
+        REQUIRE(words[6] == "pear");
+    }
+
+    TEST_CASE("SliceSort_MatchesStdSort")
+    {
+        SECTION("Random keys")
+        {
+            require_matches_std_sort(random_keys(5000, 1, "abcdefghijklmnopqrstuvwxyz", 12));
+        }
+
+        SECTION("Small alphabet with duplicates")
+        {
+            require_matches_std_sort(random_keys(5000, 2, "ab", 10));
+        }
+
+        SECTION("Non-ASCII bytes")
+        {
+            // Ordering of bytes 0x80 and above must match operator< whether char is signed or not.
+            require_matches_std_sort(random_keys(3000, 3, "a\x7F\x80\xFF\x01", 6));
+        }
+
+        SECTION("Long common prefixes")
+        {
+            std::vector<std::string> keys = random_keys(2000, 4, "xyz", 5);
+            for (auto& key : keys)
+            {
+                key = "2024-06-01T12:00:00 host-17 service=" + key;
+            }
+            keys.push_back("2024-06-01T12:00:00 host-17 service=");
+            keys.push_back("2024-06-01T12:00:00 host-17 service");
+            require_matches_std_sort(keys);
+        }
+
+        SECTION("Nested prefixes")
+        {
+            std::vector<std::string> keys;
+            for (int i = 0; i < 300; ++i)
+            {
+                keys.push_back(std::string(300 - i, 'a'));
+                keys.push_back(std::string(i, 'a') + "b");
+            }
+            require_matches_std_sort(keys);
+        }
+    }
+
+    TEST_CASE("SliceSort_Parallel")
+    {
+        std::vector<std::string> keys = random_keys((1 << 20) + 5000, 5, "abcd", 9);
+        std::vector<StringSlice> sorted = to_slices(keys);
+        std::vector<StringSlice> expected = sorted;
+
+        ThreadPoolExecutor executor(4);
+        sort_slices(sorted.data(), sorted.data() + sorted.size(), executor);
+        sort_slices(expected.data(), expected.data() + expected.size());
+
+        bool same = true;
+        for (size_t i = 0; i < sorted.size(); ++i)
+        {
+            same = same && sorted[i] == expected[i];
+        }
+        REQUIRE(same);
+        REQUIRE(std::is_sorted(sorted.begin(), sorted.end()));
+    }
+}
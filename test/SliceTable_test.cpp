@@ -0,0 +1,154 @@
+#include "catch.hpp"
+#include <string>
+#include <vector>
+
+#include "SliceTable.h"
+
+namespace slice_table_tests
+{
+    using namespace scottz0r;
+
+    TEST_CASE("SliceTable_Packed")
+    {
+        static_assert(SliceTable::max_offset == 0xFFFFFFFFull, "32-bit offsets");
+        static_assert(SliceTable40::max_offset == 0xFFFFFFFFFFull, "40-bit offsets");
+        static_assert(SliceTable40::max_length == 0xFFFFFF, "24-bit lengths");
+
+        const char text[] = "the quick brown fox";
+        StringSlice base = to_slice(text);
+
+        SECTION("Append and access")
+        {
+            uint64_t entries[4];
+            SliceTable table(StringSlice64(base.data(), base.size()), entries);
+            REQUIRE(table.capacity() == 4);
+            REQUIRE(table.append(base.substr(16, 3)));
+            REQUIRE(table.append(base.substr(4, 5)));
+            REQUIRE(table.append(base.substr(0, 9)));
+            REQUIRE(table.append(StringSlice(base.data() + 19, 0)));
+
+            REQUIRE(table.size() == 4);
+            REQUIRE(table[0] == "fox");
+            REQUIRE(table[1] == "quick");
+            REQUIRE(table[2] == "the quick");
+            REQUIRE(table[2].data() == base.data());
+            REQUIRE(table[3].empty());
+
+            REQUIRE_FALSE(table.append(base.substr(0, 3)));
+            table.clear();
+            REQUIRE(table.size() == 0);
+            REQUIRE(table.append(base.substr(0, 3)));
+        }
+
+        SECTION("Outside the base")
+        {
+            uint64_t entries[4];
+            SliceTable40 table(StringSlice64(base.data(), 9), entries);
+            REQUIRE(table.append(base.substr(4, 5)));
+            REQUIRE_FALSE(table.append(base.substr(4, 6)));
+            REQUIRE_FALSE(table.append(base.substr(10, 1)));
+            REQUIRE_FALSE(table.append("the"));
+            REQUIRE(table.size() == 1);
+        }
+
+        SECTION("Split")
+        {
+            uint64_t entries[8];
+            SliceTable table(StringSlice64(base.data(), base.size()), entries);
+            REQUIRE(table.append_split(base, ' '));
+            REQUIRE(table.size() == 4);
+            REQUIRE(table[0] == "the");
+            REQUIRE(table[3] == "fox");
+
+            table.clear();
+            const char csv[] = ",a,,b,";
+            SliceTable csv_table(StringSlice64(csv, 6), entries);
+            REQUIRE(csv_table.append_split(to_slice(csv), ','));
+            REQUIRE(csv_table.size() == 5);
+            REQUIRE(csv_table[0].empty());
+            REQUIRE(csv_table[1] == "a");
+            REQUIRE(csv_table[2].empty());
+            REQUIRE(csv_table[3] == "b");
+            REQUIRE(csv_table[4].empty());
+
+            uint64_t small[2];
+            SliceTable full(StringSlice64(base.data(), base.size()), small);
+            REQUIRE_FALSE(full.append_split(base, ' '));
+            REQUIRE(full.size() == 2);
+        }
+
+        SECTION("Iterator range")
+        {
+            std::vector<StringSlice> tokens = { base.substr(0, 3), base.substr(10, 5) };
+            uint64_t entries[4];
+            SliceTable table(StringSlice64(base.data(), base.size()), entries);
+            REQUIRE(table.append(tokens.begin(), tokens.end()));
+            REQUIRE(table.size() == 2);
+            REQUIRE(table[1] == "brown");
+        }
+    }
+
+    TEST_CASE("SliceTable_Offsets")
+    {
+        const char text[] = "alpha\nbeta\n\ngamma";
+        StringSlice base = to_slice(text);
+
+        SECTION("Split fields")
+        {
+            uint32_t offsets[5];
+            OffsetSliceTable table(base, 1, offsets);
+            REQUIRE(table.capacity() == 4);
+            REQUIRE(table.append_split(base, '\n'));
+            REQUIRE(table.size() == 4);
+            REQUIRE(table[0] == "alpha");
+            REQUIRE(table[1] == "beta");
+            REQUIRE(table[2].empty());
+            REQUIRE(table[3] == "gamma");
+            REQUIRE_FALSE(table.append(base.substr(0, 1)));
+        }
+
+        SECTION("Packed pool")
+        {
+            uint32_t offsets[8];
+            OffsetSliceTable table(base, 0, offsets);
+            REQUIRE(table.append(base.substr(0, 2)));
+            REQUIRE(table.append(base.substr(2, 3)));
+            REQUIRE(table.append(base.substr(5, 0)));
+            REQUIRE(table.append(base.substr(5, 5)));
+            REQUIRE(table[1] == "pha");
+            REQUIRE(table[2].empty());
+            REQUIRE(table[3] == "\nbeta");
+
+            // Tokens must be back to back.
+            REQUIRE_FALSE(table.append(base.substr(11, 1)));
+            REQUIRE(table.size() == 4);
+        }
+
+        SECTION("Many tokens")
+        {
+            std::string storage;
+            for (int i = 0; i < 10000; ++i)
+            {
+                storage += std::to_string(i);
+                storage += ' ';
+            }
+            storage.pop_back();
+            StringSlice corpus(storage.data(), (StringSlice::size_type)storage.size());
+
+            std::vector<uint32_t> offsets(10001);
+            OffsetSliceTable table(corpus, 1, offsets.data(), offsets.size());
+            std::vector<uint64_t> entries(10000);
+            SliceTable packed(StringSlice64(corpus.data(), corpus.size()), entries.data(), entries.size());
+
+            REQUIRE(table.append_split(corpus, ' '));
+            REQUIRE(packed.append_split(corpus, ' '));
+            REQUIRE(table.size() == 10000);
+            for (size_t i = 0; i < table.size(); i += 997)
+            {
+                std::string expected = std::to_string(i);
+                REQUIRE(table[i] == StringSlice(expected.c_str()));
+                REQUIRE(packed[i] == table[i]);
+            }
+        }
+    }
+}
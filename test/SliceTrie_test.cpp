@@ -0,0 +1,271 @@
+#include "catch.hpp"
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "SliceTrie.h"
+#include "TestUtil.h"
+
+namespace slice_trie_tests
+{
+    using namespace scottz0r;
+    using namespace test_util;
+
+    // Same order as StringSlice, which compares char values.
+    struct SliceLess
+    {
+        bool operator()(const std::string& a, const std::string& b) const
+        {
+            return to_slice(a) < to_slice(b);
+        }
+    };
+
+    static std::vector<std::pair<std::string, int>> collect(const SliceTrie<int>& trie, const StringSlice& prefix)
+    {
+        std::vector<std::pair<std::string, int>> result;
+        trie.for_each_prefix(prefix, [&](const StringSlice& key, const int& value) {
+            result.push_back(std::make_pair(std::string(key.data(), key.size()), value));
+        });
+        return result;
+    }
+
+    TEST_CASE("SliceTrie_Basic")
+    {
+        std::vector<char> buffer(16 * 1024);
+        SliceArena arena(buffer.data(), buffer.size());
+        SliceTrie<int> trie(arena);
+
+        REQUIRE(trie.empty());
+        REQUIRE(trie.find("a") == nullptr);
+
+        REQUIRE(trie.insert("/api/users", 1));
+        REQUIRE(trie.insert("/api/users/", 2));
+        REQUIRE(trie.insert("/api", 3));
+        REQUIRE(trie.insert("/static", 4));
+        REQUIRE(trie.insert("", 5));
+        REQUIRE(trie.insert("/api/orders", 6));
+        REQUIRE(trie.size() == 6);
+
+        REQUIRE(*trie.find("/api/users") == 1);
+        REQUIRE(*trie.find("/api/users/") == 2);
+        REQUIRE(*trie.find("/api") == 3);
+        REQUIRE(*trie.find("/static") == 4);
+        REQUIRE(*trie.find("") == 5);
+        REQUIRE(*trie.find("/api/orders") == 6);
+        REQUIRE(trie.find("/api/") == nullptr);
+        REQUIRE(trie.find("/api/user") == nullptr);
+        REQUIRE(trie.find("/api/users/1") == nullptr);
+        REQUIRE(trie.find("/stat") == nullptr);
+
+        // Replace a value.
+        REQUIRE(trie.insert("/api", 30));
+        REQUIRE(trie.size() == 6);
+        REQUIRE(*trie.find("/api") == 30);
+        *trie.find("/api") = 3;
+
+        // Keys are copied.
+        std::string temp = "/tmp";
+        REQUIRE(trie.insert(StringSlice(temp.data(), 4), 7));
+        temp[1] = 'x';
+        REQUIRE(*trie.find("/tmp") == 7);
+    }
+
+    TEST_CASE("SliceTrie_LongestPrefixMatch")
+    {
+        std::vector<char> buffer(16 * 1024);
+        SliceArena arena(buffer.data(), buffer.size());
+        SliceTrie<int> trie(arena);
+
+        REQUIRE(trie.longest_prefix_match("/anything") == nullptr);
+
+        REQUIRE(trie.insert("/", 1));
+        REQUIRE(trie.insert("/api/", 2));
+        REQUIRE(trie.insert("/api/v2/", 3));
+        REQUIRE(trie.insert("/api/v2/users", 4));
+        REQUIRE(trie.insert("/static/", 5));
+
+        StringSlice::size_type size = 0;
+        REQUIRE(*trie.longest_prefix_match("/api/v2/users/17", &size) == 4);
+        REQUIRE(size == 13);
+        REQUIRE(*trie.longest_prefix_match("/api/v2/orders", &size) == 3);
+        REQUIRE(size == 8);
+        REQUIRE(*trie.longest_prefix_match("/api/v1/orders", &size) == 2);
+        REQUIRE(size == 5);
+        REQUIRE(*trie.longest_prefix_match("/api", &size) == 1);
+        REQUIRE(size == 1);
+        REQUIRE(*trie.longest_prefix_match("/static/", &size) == 5);
+        REQUIRE(size == 8);
+        REQUIRE(trie.longest_prefix_match("api") == nullptr);
+        REQUIRE(trie.longest_prefix_match("") == nullptr);
+    }
+
+    TEST_CASE("SliceTrie_Prefix")
+    {
+        std::vector<char> buffer(16 * 1024);
+        SliceArena arena(buffer.data(), buffer.size());
+        SliceTrie<int> trie(arena);
+
+        const char* keys[] = { "sensor/a/temp", "sensor/a/hum", "sensor/b/temp", "sensor", "status", "sensors" };
+        for (int i = 0; i < 6; ++i)
+        {
+            REQUIRE(trie.insert(keys[i], i));
+        }
+
+        auto all = collect(trie, "");
+        REQUIRE(all.size() == 6);
+        for (size_t i = 1; i < all.size(); ++i)
+        {
+            REQUIRE(all[i - 1].first < all[i].first);
+        }
+
+        auto sensor_a = collect(trie, "sensor/a/");
+        REQUIRE(sensor_a.size() == 2);
+        REQUIRE(sensor_a[0].first == "sensor/a/hum");
+        REQUIRE(sensor_a[0].second == 1);
+        REQUIRE(sensor_a[1].first == "sensor/a/temp");
+
+        REQUIRE(collect(trie, "sensor").size() == 5);
+        REQUIRE(collect(trie, "sensor/").size() == 3);
+        REQUIRE(collect(trie, "sensor/b/temp").size() == 1);
+        REQUIRE(collect(trie, "sensor/b/temperature").empty());
+        REQUIRE(collect(trie, "st").size() == 1);
+        REQUIRE(collect(trie, "x").empty());
+
+        size_t count = 0;
+        trie.for_each([&](const StringSlice&, const int&) { ++count; });
+        REQUIRE(count == 6);
+    }
+
+    TEST_CASE("SliceTrie_ArenaFull")
+    {
+        char buffer[256];
+        SliceArena arena(buffer);
+        SliceTrie<int> trie(arena);
+
+        int inserted = 0;
+        std::vector<std::string> keys;
+        for (int i = 0; i < 100; ++i)
+        {
+            keys.push_back("key" + std::to_string(i));
+        }
+
+        for (const auto& key : keys)
+        {
+            size_t used = arena.mark();
+            if (!trie.insert(to_slice(key), inserted))
+            {
+                REQUIRE(arena.mark() == used);
+                break;
+            }
+            ++inserted;
+        }
+
+        REQUIRE(inserted > 0);
+        REQUIRE(inserted < 100);
+        REQUIRE(trie.size() == (size_t)inserted);
+        for (int i = 0; i < inserted; ++i)
+        {
+            REQUIRE(*trie.find(to_slice(keys[i])) == i);
+        }
+
+        SliceTrie<int> no_arena;
+        REQUIRE_FALSE(no_arena.insert("a", 1));
+    }
+
+    TEST_CASE("SliceTrie_BruteForce")
+    {
+        std::mt19937 rng(45);
+        std::vector<char> buffer(4 * 1024 * 1024);
+
+        for (int round = 0; round < 4; ++round)
+        {
+            SliceArena arena(buffer.data(), buffer.size());
+            SliceTrie<int> trie(arena);
+            std::map<std::string, int, SliceLess> expected;
+
+            // Round 0 uses a small alphabet for deep paths, later rounds use all bytes to fill Node48 and Node256.
+            std::uniform_int_distribution<int> length(0, round == 0 ? 8 : 3);
+            std::uniform_int_distribution<int> byte(0, round == 0 ? 2 : 255);
+
+            auto random_key = [&]() {
+                std::string s;
+                for (int n = length(rng); n > 0; --n)
+                {
+                    s += (char)(round == 0 ? 'a' + byte(rng) : byte(rng));
+                }
+                return s;
+            };
+
+            for (int i = 0; i < 3000; ++i)
+            {
+                std::string key = random_key();
+                expected[key] = i;
+                REQUIRE(trie.insert(to_slice(key), i));
+            }
+
+            REQUIRE(trie.size() == expected.size());
+
+            std::vector<char> frozen_buffer(4 * 1024 * 1024);
+            for (int pass = 0; pass < 2; ++pass)
+            {
+                // The same checks hold after freezing into a second arena.
+                std::vector<std::pair<std::string, int>> all = collect(trie, "");
+                REQUIRE(all == std::vector<std::pair<std::string, int>>(expected.begin(), expected.end()));
+
+                for (int q = 0; q < 1000; ++q)
+                {
+                    std::string query = random_key();
+                    StringSlice key(query.data(), (StringSlice::size_type)query.size());
+                    auto it = expected.find(query);
+                    const int* found = trie.find(key);
+                    REQUIRE((found != nullptr) == (it != expected.end()));
+                    if (found)
+                    {
+                        REQUIRE(*found == it->second);
+                    }
+
+                    int best = -1;
+                    StringSlice::size_type best_size = 0;
+                    for (size_t n = 0; n <= query.size(); ++n)
+                    {
+                        auto p = expected.find(query.substr(0, n));
+                        if (p != expected.end())
+                        {
+                            best = p->second;
+                            best_size = (StringSlice::size_type)n;
+                        }
+                    }
+
+                    StringSlice::size_type size = 0;
+                    const int* match = trie.longest_prefix_match(key, &size);
+                    REQUIRE((match != nullptr) == (best >= 0));
+                    if (match)
+                    {
+                        REQUIRE(*match == best);
+                        REQUIRE(size == best_size);
+                    }
+
+                    size_t under = 0;
+                    for (auto p = expected.lower_bound(query); p != expected.end() &&
+                        p->first.compare(0, query.size(), query) == 0; ++p)
+                    {
+                        ++under;
+                    }
+                    REQUIRE(collect(trie, key).size() == under);
+                }
+
+                if (pass == 0)
+                {
+                    SliceArena frozen_arena(frozen_buffer.data(), frozen_buffer.size());
+                    REQUIRE(trie.freeze(frozen_arena));
+                    REQUIRE(trie.frozen());
+                    REQUIRE_FALSE(trie.insert("new", 1));
+
+                    // The frozen trie does not use the original arena.
+                    std::fill(buffer.begin(), buffer.end(), (char)0xCD);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,226 @@
+#include "catch.hpp"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "SortedSliceSet.h"
+#include "TestUtil.h"
+
+namespace sorted_slice_set_tests
+{
+    using namespace scottz0r;
+    using namespace test_util;
+
+    TEST_CASE("SortedSliceSet_Basic")
+    {
+        char buffer[1024];
+        SliceArena arena(buffer);
+
+        StringSlice keys[] = { "", "apple", "applesauce", "apply", "banana", "band", "bandana", "can" };
+        SortedSliceSet set;
+        REQUIRE(set.build(keys, arena, 3));
+        REQUIRE(set.size() == 8);
+        REQUIRE(set.max_size() == 10);
+        REQUIRE(set.memory_size() <= arena.mark());
+
+        for (const auto& key : keys)
+        {
+            REQUIRE(set.contains(key));
+        }
+
+        REQUIRE_FALSE(set.contains("appl"));
+        REQUIRE_FALSE(set.contains("apples"));
+        REQUIRE_FALSE(set.contains("bandanas"));
+        REQUIRE_FALSE(set.contains("zebra"));
+
+        REQUIRE(set.lower_bound("") == 0);
+        REQUIRE(set.lower_bound("a") == 1);
+        REQUIRE(set.lower_bound("apples") == 2);
+        REQUIRE(set.lower_bound("banana") == 4);
+        REQUIRE(set.lower_bound("bandanas") == 7);
+        REQUIRE(set.lower_bound("zebra") == 8);
+
+        size_t first;
+        size_t last;
+        set.prefix_range("app", first, last);
+        REQUIRE(first == 1);
+        REQUIRE(last == 4);
+
+        set.prefix_range("band", first, last);
+        REQUIRE(first == 5);
+        REQUIRE(last == 7);
+
+        set.prefix_range("cat", first, last);
+        REQUIRE(first == last);
+
+        set.prefix_range("", first, last);
+        REQUIRE(first == 0);
+        REQUIRE(last == 8);
+
+        char entry[16];
+        REQUIRE(set.copy_to(2, entry, sizeof(entry)) == 10);
+        REQUIRE(StringSlice(entry, 10) == "applesauce");
+        REQUIRE(set.copy_to(6, entry, sizeof(entry)) == 7);
+        REQUIRE(StringSlice(entry, 7) == "bandana");
+        REQUIRE(set.copy_to(8, entry, sizeof(entry)) == SortedSliceSet::npos);
+        REQUIRE(set.copy_to(0, entry, 4) == SortedSliceSet::npos);
+    }
+
+    TEST_CASE("SortedSliceSet_Build")
+    {
+        char buffer[256];
+        SliceArena arena(buffer);
+        SortedSliceSet set;
+
+        // Repeated keys are stored once.
+        StringSlice repeated[] = { "a", "a", "b", "b", "b", "c" };
+        REQUIRE(set.build(repeated, arena, 2));
+        REQUIRE(set.size() == 3);
+        REQUIRE(set.lower_bound("c") == 2);
+
+        size_t used = arena.mark();
+        StringSlice unsorted[] = { "a", "c", "b" };
+        REQUIRE_FALSE(set.build(unsorted, arena));
+        REQUIRE(set.empty());
+        REQUIRE(arena.mark() == used);
+        REQUIRE_FALSE(set.contains("a"));
+        REQUIRE(set.lower_bound("a") == 0);
+
+        REQUIRE_FALSE(set.build(repeated, arena, 0));
+
+        char small[8];
+        SliceArena small_arena(small);
+        StringSlice long_keys[] = { "abcdefgh", "abcdefghij" };
+        REQUIRE_FALSE(set.build(long_keys, small_arena));
+        REQUIRE(small_arena.mark() == 0);
+
+        REQUIRE(set.build(nullptr, 0, arena));
+        REQUIRE(set.empty());
+        REQUIRE(set.lower_bound("x") == 0);
+    }
+
+    TEST_CASE("SortedSliceSet_ForEach")
+    {
+        std::vector<std::string> strings;
+        for (int i = 0; i < 100; ++i)
+        {
+            strings.push_back("https://example.com/items/" + std::to_string(1000 + i));
+        }
+
+        std::vector<StringSlice> keys = to_slices(strings);
+        std::vector<char> buffer(8192);
+        SliceArena arena(buffer.data(), buffer.size());
+        SortedSliceSet set;
+        REQUIRE(set.build(keys.data(), keys.size(), arena, 16));
+
+        // Front coding stores the shared URL prefix once per block.
+        size_t total = 0;
+        for (const auto& s : strings)
+        {
+            total += s.size();
+        }
+        REQUIRE(set.memory_size() * 3 < total);
+
+        char entry[64];
+        std::vector<std::string> decoded;
+        REQUIRE(set.for_each(10, 60, entry, sizeof(entry), [&](const StringSlice& s) {
+            decoded.push_back(std::string(s.data(), s.size()));
+        }));
+
+        REQUIRE(decoded.size() == 50);
+        for (size_t i = 0; i < decoded.size(); ++i)
+        {
+            REQUIRE(decoded[i] == strings[10 + i]);
+        }
+
+        REQUIRE_FALSE(set.for_each(10, 101, entry, sizeof(entry), [](const StringSlice&) {}));
+        REQUIRE_FALSE(set.for_each(20, 10, entry, sizeof(entry), [](const StringSlice&) {}));
+
+        // Empty ranges, including on a set with no blocks.
+        size_t calls = 0;
+        REQUIRE(set.for_each(30, 30, entry, sizeof(entry), [&](const StringSlice&) { ++calls; }));
+        SortedSliceSet none;
+        REQUIRE(none.for_each(0, 0, entry, sizeof(entry), [&](const StringSlice&) { ++calls; }));
+        REQUIRE_FALSE(none.for_each(0, 1, entry, sizeof(entry), [&](const StringSlice&) { ++calls; }));
+        REQUIRE(calls == 0);
+
+        size_t first;
+        size_t last;
+        set.prefix_range("https://example.com/items/10", first, last);
+        REQUIRE(first == 0);
+        REQUIRE(last == 100);
+        set.prefix_range("https://example.com/items/105", first, last);
+        REQUIRE(first == 50);
+        REQUIRE(last == 60);
+    }
+
+    TEST_CASE("SortedSliceSet_BruteForce")
+    {
+        std::mt19937 rng(44);
+        std::uniform_int_distribution<int> length(0, 6);
+        std::uniform_int_distribution<int> letter(0, 3);
+        std::vector<char> buffer(1 << 16);
+
+        for (int round = 0; round < 20; ++round)
+        {
+            // Small alphabet so keys share long prefixes. Include bytes with the high bit set.
+            const char alphabet[] = { 'a', 'b', 'c', (char)0xE9 };
+            std::vector<std::string> strings;
+            for (int i = 0; i < 300; ++i)
+            {
+                std::string s;
+                for (int n = length(rng); n > 0; --n)
+                {
+                    s += alphabet[letter(rng)];
+                }
+                strings.push_back(s);
+            }
+
+            std::vector<StringSlice> keys = to_slices(strings);
+            std::sort(keys.begin(), keys.end());
+            std::vector<StringSlice> unique = keys;
+            unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
+
+            SliceArena arena(buffer.data(), buffer.size());
+            SortedSliceSet set;
+            unsigned int block_size = 1 + round % 40;
+            REQUIRE(set.build(keys.data(), keys.size(), arena, block_size));
+            REQUIRE(set.size() == unique.size());
+
+            char entry[8];
+            for (size_t i = 0; i < unique.size(); ++i)
+            {
+                size_t size = set.copy_to(i, entry, sizeof(entry));
+                REQUIRE(StringSlice(entry, (StringSlice::size_type)size) == unique[i]);
+            }
+
+            for (int q = 0; q < 200; ++q)
+            {
+                std::string query;
+                for (int n = length(rng); n > 0; --n)
+                {
+                    query += alphabet[letter(rng)];
+                }
+
+                StringSlice key(query.data(), (StringSlice::size_type)query.size());
+                size_t expected = std::lower_bound(unique.begin(), unique.end(), key) - unique.begin();
+                REQUIRE(set.lower_bound(key) == expected);
+                REQUIRE(set.contains(key) == std::binary_search(unique.begin(), unique.end(), key));
+
+                size_t expected_last = expected;
+                while (expected_last < unique.size() && unique[expected_last].size() >= key.size() &&
+                    unique[expected_last].substr(0, key.size()) == key)
+                {
+                    ++expected_last;
+                }
+
+                size_t first;
+                size_t last;
+                set.prefix_range(key, first, last);
+                REQUIRE(first == expected);
+                REQUIRE(last == expected_last);
+            }
+        }
+    }
+}
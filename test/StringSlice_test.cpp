@@ -1,6 +1,8 @@
 #define CATCH_CONFIG_MAIN
 #include "catch.hpp"
 #include <cstring>
+#include <string>
+#include <unordered_map>
 
 #include "StringSlice.h"
 
@@ -351,6 +353,27 @@ namespace string_slice_tests
             auto pos_nope = ss.find('Z');
             REQUIRE(pos_nope == StringSlice::npos);
         }
+
+        SECTION("Find Char Long")
+        {
+            StringSlice ss("0123456789abcdefghijklmnopqrstuvwxyz0123456789");
+
+            REQUIRE(ss.find('z') == 35);
+            REQUIRE(ss.find('0', 1) == 36);
+            REQUIRE(ss.find('9', 10) == 45);
+            REQUIRE(ss.find('Z') == StringSlice::npos);
+        }
+
+        SECTION("Count Char")
+        {
+            StringSlice ss("a\nbb\n\ncccccccc\n\x80\x80\n");
+
+            REQUIRE(ss.count('\n') == 5);
+            REQUIRE(ss.count('c') == 8);
+            REQUIRE(ss.count((char)0x80) == 2);
+            REQUIRE(ss.count('z') == 0);
+            REQUIRE(StringSlice().count('a') == 0);
+        }
     }
 
     TEST_CASE("StringSlice_Substr")
@@ -563,4 +586,200 @@ namespace string_slice_tests
             REQUIRE(line.empty());
         }
     }
+
+    TEST_CASE("StringSlice_Find_Substring")
+    {
+        StringSlice ss("abcabcd");
+
+        REQUIRE(ss.find("abc") == 0);
+        REQUIRE(ss.find("abc", 1) == 3);
+        REQUIRE(ss.find("abcd") == 3);
+        REQUIRE(ss.find("abce") == StringSlice::npos);
+        REQUIRE(ss.find("abcabcdx") == StringSlice::npos);
+        REQUIRE(ss.find("") == 0);
+        REQUIRE(ss.find("", 7) == 7);
+        REQUIRE(ss.find("", 8) == StringSlice::npos);
+        REQUIRE(StringSlice().find("a") == StringSlice::npos);
+    }
+
+    TEST_CASE("StringSlice_Case_Insensitive")
+    {
+        SECTION("iequals")
+        {
+            REQUIRE(StringSlice("Content-Length").iequals("content-length"));
+            REQUIRE(StringSlice("CONTENT-LENGTH").iequals("content-length"));
+            REQUIRE_FALSE(StringSlice("Content-Length").iequals("content-lengtj"));
+            REQUIRE_FALSE(StringSlice("abc").iequals("abcd"));
+
+            // '@' and '`' differ only in bit 0x20 but are not letters.
+            REQUIRE_FALSE(StringSlice("@@@@@@@@@").iequals("`````````"));
+            REQUIRE_FALSE(StringSlice("[").iequals("{"));
+
+            const char upper[] = { (char)0xc3, (char)0x9c, 0 };
+            const char lower[] = { (char)0xc3, (char)0xbc, 0 };
+            REQUIRE_FALSE(StringSlice(upper).iequals(lower));
+        }
+
+        SECTION("icompare")
+        {
+            REQUIRE(StringSlice("HELLO world").icompare("hello WORLD") == 0);
+            REQUIRE(StringSlice("abcdefghA").icompare("ABCDEFGHb") == -1);
+            REQUIRE(StringSlice("abcdefghC").icompare("ABCDEFGHb") == 1);
+            REQUIRE(StringSlice("abc").icompare("ABCD") == -1);
+            REQUIRE(StringSlice("abcd").icompare("ABC") == 1);
+        }
+
+        SECTION("ifind char")
+        {
+            StringSlice ss("0123456789abcdefXyZ");
+
+            REQUIRE(ss.ifind('x') == 16);
+            REQUIRE(ss.ifind('Y') == 17);
+            REQUIRE(ss.ifind('A') == 10);
+            REQUIRE(ss.ifind('a', 11) == StringSlice::npos);
+            REQUIRE(ss.ifind('!') == StringSlice::npos);
+            REQUIRE(ss.ifind('z', 100) == StringSlice::npos);
+        }
+
+        SECTION("ifind substring")
+        {
+            StringSlice ss("Host: Example.COM\r\n");
+
+            REQUIRE(ss.ifind("example.com") == 6);
+            REQUIRE(ss.ifind("HOST") == 0);
+            REQUIRE(ss.ifind("com", 7) == 14);
+            REQUIRE(ss.ifind("example.org") == StringSlice::npos);
+        }
+
+        SECTION("istarts_with")
+        {
+            REQUIRE(StringSlice("Transfer-Encoding: chunked").istarts_with("TRANSFER-encoding"));
+            REQUIRE(StringSlice("abc").istarts_with(""));
+            REQUIRE_FALSE(StringSlice("ab").istarts_with("abc"));
+            REQUIRE_FALSE(StringSlice("abd").istarts_with("abc"));
+        }
+
+        SECTION("Hashes")
+        {
+            REQUIRE(StringSlice("Accept-Encoding").ihash() == StringSlice("ACCEPT-encoding").ihash());
+            REQUIRE(StringSlice("Accept-Encoding").ihash() != StringSlice("Accept-Encodinh").ihash());
+            REQUIRE(StringSlice("Accept-Encoding").hash() != StringSlice("ACCEPT-encoding").hash());
+            REQUIRE(StringSlice("abc").hash() == StringSlice("xabcx").substr(1, 3).hash());
+            REQUIRE(StringSlice("a").hash() != StringSlice("a\0", 2).hash());
+        }
+
+        SECTION("Hash map keys")
+        {
+            std::unordered_map<StringSlice, int, StringSliceIHash, StringSliceIEqual> headers;
+            headers[StringSlice("Content-Type")] = 1;
+            headers[StringSlice("content-length")] = 2;
+
+            REQUIRE(headers.size() == 2);
+            REQUIRE(headers.at(StringSlice("CONTENT-TYPE")) == 1);
+            REQUIRE(headers.at(StringSlice("Content-Length")) == 2);
+            REQUIRE(headers.count(StringSlice("Host")) == 0);
+        }
+    }
+
+    TEST_CASE("BasicStringSlice_Widths")
+    {
+        SECTION("UTF-16")
+        {
+            const char16_t text[] = u"Hello, W\u00F6rld! Hello again, WORLD.";
+            U16StringSlice ss = to_slice(text);
+            REQUIRE(ss.size() == 33);
+            REQUIRE(ss.find(u'W') == 7);
+            REQUIRE(ss.find(u'\u00F6') == 8);
+            REQUIRE(ss.find(u'W', 8) == 27);
+            REQUIRE(ss.find(u'z') == U16StringSlice::npos);
+            REQUIRE(ss.count(u'l') == 5);
+            REQUIRE(ss.find(to_slice(u"again")) == 20);
+            REQUIRE(ss.ifind(u'w', 8) == 27);
+            REQUIRE(ss.ifind(to_slice(u"WORLD.")) == 27);
+            REQUIRE(ss.substr(27).iequals(to_slice(u"world.")));
+            REQUIRE(ss.substr(27).ihash() == to_slice(u"world.").ihash());
+            REQUIRE(ss.substr(0, 5) == to_slice(u"Hello"));
+            REQUIRE(get_line(to_slice(u"ab\ncd")).size() == 3);
+
+            // Characters whose low byte is an upper case ASCII letter are not letters.
+            const char16_t not_letters[] = { 0x0141, 0x0161, 0 };
+            REQUIRE_FALSE(to_slice(not_letters).iequals(to_slice(u"\u0161\u0161")));
+        }
+
+        SECTION("UTF-32")
+        {
+            const char32_t text[] = U"abcABCabc\U0001F600xyz";
+            BasicStringSlice<char32_t, unsigned int> ss = to_slice(text);
+            REQUIRE(ss.find(U'\U0001F600') == 9);
+            REQUIRE(ss.count(U'a') == 2);
+            REQUIRE(ss.ifind(U'a', 1) == 3);
+            REQUIRE(ss.find(to_slice(U"xyz")) == 10);
+            REQUIRE(ss.substr(0, 3).iequals(ss.substr(3, 3)));
+        }
+
+#if defined(__cpp_char8_t)
+        SECTION("UTF-8 code units")
+        {
+            U8StringSlice ss = to_slice(u8"na\u00EFve caf\u00E9");
+            REQUIRE(ss.size() == 12);
+            REQUIRE(ss.find(u8'v') == 4);
+            REQUIRE(ss.find(to_slice(u8"caf")) == 7);
+        }
+#endif
+
+        SECTION("Bytes")
+        {
+            const uint8_t bytes[] = { 0x00, 0xFF, 0x41, 0x80, 0xFF, 0x61, 0x00, 0xFF, 0x12 };
+            ByteSlice ss(bytes, sizeof(bytes));
+            REQUIRE(ss.find(0xFF) == 1);
+            REQUIRE(ss.find(0xFF, 2) == 4);
+            REQUIRE(ss.count(0xFF) == 3);
+            REQUIRE(ss.count(0x00) == 2);
+            REQUIRE(ss.ifind(0x61) == 2);
+        }
+
+        SECTION("Matches char slices")
+        {
+            // Every width must agree with the char version on ASCII text.
+            const char* text = "The Quick brown fox jumps over the lazy dog. THE QUICK BROWN FOX!";
+            StringSlice narrow(text);
+            std::u16string wide_storage(text, text + narrow.size());
+            U16StringSlice wide(wide_storage.data(), (unsigned int)wide_storage.size());
+
+            for (char c = ' '; c < 127; ++c)
+            {
+                REQUIRE(wide.find((char16_t)c, 3) == narrow.find(c, 3));
+                REQUIRE(wide.count((char16_t)c) == narrow.count(c));
+                REQUIRE(wide.ifind((char16_t)c) == narrow.ifind(c));
+            }
+
+            REQUIRE(wide.icompare(wide.substr(1)) == narrow.icompare(narrow.substr(1)));
+        }
+    }
+
+    TEST_CASE("BasicStringSlice_Sizes")
+    {
+        static_assert(sizeof(SmallStringSlice::size_type) == 2, "16-bit sizes");
+        static_assert(sizeof(StringSlice64::size_type) == 8, "64-bit sizes");
+        static_assert(SmallStringSlice::npos == 0xFFFF, "npos matches the size type");
+        static_assert(sizeof(SmallStringSlice) <= sizeof(StringSlice64), "smaller sizes never give larger slices");
+
+        const char* text = "alpha beta gamma beta";
+        SmallStringSlice small(text);
+        StringSlice64 big(text);
+
+        REQUIRE(small.size() == 21);
+        REQUIRE(small.find("beta") == 6);
+        REQUIRE(small.find("beta", 7) == 17);
+        REQUIRE(small.find("delta") == SmallStringSlice::npos);
+        REQUIRE(big.find("beta", 7) == 17);
+        REQUIRE(big.find("delta") == StringSlice64::npos);
+        REQUIRE(big.substr(6, 4) == "beta");
+        REQUIRE(big.hash() == StringSlice(text).hash());
+        REQUIRE(small.ihash() == StringSlice(text).ihash());
+
+        std::unordered_map<StringSlice64, int, StringSliceHash> map;
+        map[big.substr(0, 5)] = 1;
+        REQUIRE(map.at(StringSlice64("alpha")) == 1);
+    }
 }
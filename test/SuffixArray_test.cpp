@@ -0,0 +1,175 @@
+#include "catch.hpp"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "SuffixArray.h"
+#include "TestUtil.h"
+
+namespace suffix_array_tests
+{
+    using namespace scottz0r;
+    using namespace test_util;
+
+    static std::vector<uint32_t> naive_suffix_array(const std::string& text)
+    {
+        std::vector<uint32_t> sa(text.size());
+        for (uint32_t i = 0; i < sa.size(); ++i)
+        {
+            sa[i] = i;
+        }
+
+        // std::string compares as unsigned bytes, like the suffix array.
+        std::sort(sa.begin(), sa.end(), [&](uint32_t a, uint32_t b) {
+            return text.compare(a, std::string::npos, text, b, std::string::npos) < 0;
+        });
+        return sa;
+    }
+
+    static size_t naive_count(const std::string& text, const std::string& pattern)
+    {
+        size_t count = 0;
+        for (size_t i = 0; i + pattern.size() <= text.size(); ++i)
+        {
+            count += text.compare(i, pattern.size(), pattern) == 0 ? 1 : 0;
+        }
+        return count;
+    }
+
+    TEST_CASE("SuffixArray_Banana")
+    {
+        char buffer[4096];
+        SliceArena arena(buffer);
+        SuffixArray sa;
+        REQUIRE(sa.size() == 0);
+
+        StringSlice text = "banana";
+        REQUIRE(sa.build(text, arena));
+        REQUIRE(sa.size() == 6);
+        REQUIRE(sa.has_lcp());
+
+        // a, ana, anana, banana, na, nana
+        const StringSlice::size_type expected[] = { 5, 3, 1, 0, 4, 2 };
+        const StringSlice::size_type expected_lcp[] = { 0, 1, 3, 0, 0, 2 };
+        for (size_t i = 0; i < 6; ++i)
+        {
+            REQUIRE(sa.position(i) == expected[i]);
+            REQUIRE(sa.lcp(i) == expected_lcp[i]);
+        }
+
+        REQUIRE(sa.count("ana") == 2);
+        REQUIRE(sa.count("a") == 3);
+        REQUIRE(sa.count("banana") == 1);
+        REQUIRE(sa.count("bananas") == 0);
+        REQUIRE(sa.count("nab") == 0);
+        REQUIRE(sa.count("") == 6);
+
+        std::vector<StringSlice::size_type> positions;
+        REQUIRE(sa.locate("na", [&](StringSlice::size_type pos) { positions.push_back(pos); }) == 2);
+        std::sort(positions.begin(), positions.end());
+        REQUIRE(positions == std::vector<StringSlice::size_type>{ 2, 4 });
+
+        size_t first;
+        size_t last;
+        sa.range("an", first, last);
+        REQUIRE(first == 1);
+        REQUIRE(last == 3);
+
+        REQUIRE(sa.longest_repeated_substring() == "ana");
+    }
+
+    TEST_CASE("SuffixArray_Build")
+    {
+        alignas(uint32_t) char buffer[4096];
+        SliceArena arena(buffer);
+        SuffixArray sa;
+
+        REQUIRE(sa.build(StringSlice(""), arena));
+        REQUIRE(sa.size() == 0);
+        REQUIRE(sa.count("a") == 0);
+        REQUIRE(sa.longest_repeated_substring().empty());
+
+        arena.reset();
+        REQUIRE(sa.build("abc", arena));
+        REQUIRE(sa.longest_repeated_substring().empty());
+
+        // Without the LCP array, only the first allocation stays.
+        arena.reset();
+        REQUIRE(sa.build("abcabc", arena, false));
+        REQUIRE_FALSE(sa.has_lcp());
+        REQUIRE(arena.mark() == 7 * sizeof(uint32_t));
+        REQUIRE(sa.count("bc") == 2);
+        REQUIRE(sa.longest_repeated_substring().empty());
+
+        // Too small.
+        arena.reset();
+        std::string big(1000, 'x');
+        REQUIRE_FALSE(sa.build(StringSlice(big.data(), 1000), arena));
+        REQUIRE(sa.size() == 0);
+        REQUIRE(arena.mark() == 0);
+    }
+
+    TEST_CASE("SuffixArray_BruteForce")
+    {
+        std::mt19937 rng(48);
+        std::vector<char> buffer(1 << 20);
+
+        for (int round = 0; round < 30; ++round)
+        {
+            // Small alphabets make many repeats, which exercises the recursion.
+            int alphabet = round % 3 == 0 ? 2 : (round % 3 == 1 ? 4 : 256);
+            std::uniform_int_distribution<int> letter(0, alphabet - 1);
+            std::uniform_int_distribution<int> length(1, 2000);
+
+            std::string text;
+            for (int n = length(rng); n > 0; --n)
+            {
+                text += (char)(alphabet == 256 ? letter(rng) : 'a' + letter(rng));
+            }
+
+            SliceArena arena(buffer.data(), buffer.size());
+            SuffixArray sa;
+            REQUIRE(sa.build(to_slice(text), arena));
+
+            std::vector<uint32_t> expected = naive_suffix_array(text);
+            size_t longest = 0;
+            for (size_t i = 0; i < expected.size(); ++i)
+            {
+                REQUIRE(sa.position(i) == expected[i]);
+                if (i > 0)
+                {
+                    size_t a = expected[i - 1];
+                    size_t b = expected[i];
+                    size_t h = 0;
+                    while (a + h < text.size() && b + h < text.size() && text[a + h] == text[b + h])
+                    {
+                        ++h;
+                    }
+                    REQUIRE(sa.lcp(i) == h);
+                    longest = h > longest ? h : longest;
+                }
+            }
+
+            StringSlice repeated = sa.longest_repeated_substring();
+            REQUIRE(repeated.size() == longest);
+            if (longest > 0)
+            {
+                REQUIRE(naive_count(text, std::string(repeated.data(), repeated.size())) >= 2);
+            }
+
+            for (int q = 0; q < 50; ++q)
+            {
+                size_t pos = rng() % text.size();
+                std::string pattern = text.substr(pos, 1 + rng() % 6);
+                if (q % 2 == 1)
+                {
+                    pattern.back() = (char)(pattern.back() + 1);
+                }
+
+                REQUIRE(sa.count(to_slice(pattern)) ==
+                    naive_count(text, pattern));
+            }
+        }
+    }
+}
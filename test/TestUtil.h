@@ -0,0 +1,32 @@
+/// @file
+/// Helpers shared by the tests.
+#ifndef _SCOTTZ0R_TEST_UTIL_INCLUDE_GUARD
+#define _SCOTTZ0R_TEST_UTIL_INCLUDE_GUARD
+
+#include <string>
+#include <vector>
+
+#include "StringSlice.h"
+
+namespace test_util
+{
+    /// Returns a slice of a string's bytes. The string must outlive the slice.
+    inline scottz0r::StringSlice to_slice(const std::string& s)
+    {
+        return scottz0r::StringSlice(s.data(), (scottz0r::StringSlice::size_type)s.size());
+    }
+
+    /// Returns a slice of each string, in order. The strings must outlive the slices.
+    inline std::vector<scottz0r::StringSlice> to_slices(const std::vector<std::string>& strings)
+    {
+        std::vector<scottz0r::StringSlice> slices;
+        slices.reserve(strings.size());
+        for (const auto& s : strings)
+        {
+            slices.push_back(to_slice(s));
+        }
+        return slices;
+    }
+}
+
+#endif // _SCOTTZ0R_TEST_UTIL_INCLUDE_GUARD
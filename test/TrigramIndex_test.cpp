@@ -0,0 +1,189 @@
+#include "catch.hpp"
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "TrigramIndex.h"
+#include "TestUtil.h"
+
+namespace trigram_index_tests
+{
+    using namespace scottz0r;
+    using namespace test_util;
+
+    static std::vector<size_t> find_docs(const TrigramIndex& index, const StringSlice& needle,
+        const StringSlice* docs)
+    {
+        std::vector<size_t> found;
+        size_t count = index.find(needle, docs, [&](size_t doc, StringSlice::size_type pos) {
+            REQUIRE(docs[doc].find(needle) == pos);
+            found.push_back(doc);
+        });
+        REQUIRE(count == found.size());
+        return found;
+    }
+
+    static std::vector<size_t> scan_docs(const StringSlice& needle, const std::vector<StringSlice>& docs)
+    {
+        std::vector<size_t> found;
+        for (size_t d = 0; d < docs.size(); ++d)
+        {
+            if (docs[d].find(needle) != StringSlice::npos)
+            {
+                found.push_back(d);
+            }
+        }
+        return found;
+    }
+
+    TEST_CASE("TrigramIndex_Basic")
+    {
+        StringSlice docs[] = {
+            "GET /index.html 200",
+            "GET /images/logo.png 404",
+            "POST /api/login 200",
+            "GET /api/users 500",
+            "",
+            "ab",
+        };
+
+        TrigramIndex index;
+        REQUIRE(index.document_count() == 0);
+        REQUIRE(index.find("GET", docs, [](size_t, StringSlice::size_type) {}) == 0);
+
+        index.build(docs, 6);
+        REQUIRE(index.document_count() == 6);
+        REQUIRE(index.gram_count() > 0);
+        REQUIRE(index.gram_documents("GET") == 3);
+        REQUIRE(index.gram_documents("/ap") == 2);
+        REQUIRE(index.gram_documents("zzz") == 0);
+
+        REQUIRE(find_docs(index, "GET", docs) == std::vector<size_t>{ 0, 1, 3 });
+        REQUIRE(find_docs(index, "/api/", docs) == std::vector<size_t>{ 2, 3 });
+        REQUIRE(find_docs(index, " 200", docs) == std::vector<size_t>{ 0, 2 });
+        REQUIRE(find_docs(index, "logo.png", docs) == std::vector<size_t>{ 1 });
+        REQUIRE(find_docs(index, "DELETE", docs).empty());
+
+        // The trigrams match but the needle does not.
+        REQUIRE(find_docs(index, "GET /api/login", docs).empty());
+
+        // Short needles check every document.
+        REQUIRE(find_docs(index, "ab", docs) == std::vector<size_t>{ 5 });
+        REQUIRE(find_docs(index, "", docs).size() == 6);
+    }
+
+    TEST_CASE("TrigramIndex_Load")
+    {
+        StringSlice docs[] = { "alpha beta", "beta gamma", "gamma delta" };
+        TrigramIndex index;
+        index.build(docs, 3);
+
+        std::vector<uint64_t> copy(index.size_bytes() / sizeof(uint64_t));
+        memcpy(copy.data(), index.data(), index.size_bytes());
+
+        TrigramIndex loaded;
+        REQUIRE(loaded.load(copy.data(), copy.size() * sizeof(uint64_t)));
+        REQUIRE(loaded.document_count() == 3);
+        REQUIRE(loaded.size_bytes() == index.size_bytes());
+        REQUIRE(find_docs(loaded, "beta", docs) == std::vector<size_t>{ 0, 1 });
+        REQUIRE(find_docs(loaded, "gamma", docs) == std::vector<size_t>{ 1, 2 });
+
+        // Moving keeps the index usable.
+        TrigramIndex moved = std::move(index);
+        REQUIRE(find_docs(moved, "delta", docs) == std::vector<size_t>{ 2 });
+
+        REQUIRE_FALSE(loaded.load(copy.data(), copy.size() * sizeof(uint64_t) - 8));
+        REQUIRE(loaded.document_count() == 0);
+        copy[0] = 0;
+        REQUIRE_FALSE(loaded.load(copy.data(), copy.size() * sizeof(uint64_t)));
+        copy[0] = ((const uint64_t*)index.data())[0];
+        REQUIRE(loaded.load(copy.data(), copy.size() * sizeof(uint64_t)));
+
+        // Corrupt each table in turn. The tables start after the 4 header words.
+        const size_t gram_count = (size_t)copy[2];
+        const size_t table = (gram_count + 1) / 2;
+        uint32_t* grams = (uint32_t*)(copy.data() + 4);
+        uint32_t* counts = (uint32_t*)(copy.data() + 4 + table);
+        uint64_t* offsets = copy.data() + 4 + 2 * table;
+        unsigned char* lists = (unsigned char*)(offsets + gram_count + 1);
+        auto corrupt = [&](std::function<void()> change) {
+            std::vector<uint64_t> saved = copy;
+            change();
+            bool ok = loaded.load(copy.data(), copy.size() * sizeof(uint64_t));
+            copy = saved;
+            return ok;
+        };
+
+        REQUIRE_FALSE(corrupt([&] { std::swap(grams[0], grams[1]); }));
+        REQUIRE_FALSE(corrupt([&] { grams[gram_count - 1] = 1u << 24; }));
+        REQUIRE_FALSE(corrupt([&] { ++counts[0]; }));
+        REQUIRE_FALSE(corrupt([&] { counts[1] = 0; }));
+        REQUIRE_FALSE(corrupt([&] { offsets[1] = offsets[2] + 1; }));
+        REQUIRE_FALSE(corrupt([&] { offsets[gram_count] -= 1; }));
+        REQUIRE_FALSE(corrupt([&] { offsets[0] = 1; }));
+        REQUIRE_FALSE(corrupt([&] { lists[0] = 3; }));
+        REQUIRE_FALSE(corrupt([&] { lists[0] = 0x80; }));
+        REQUIRE_FALSE(corrupt([&] { copy[1] = 1; }));
+        REQUIRE(loaded.document_count() == 0);
+        REQUIRE(corrupt([] {}));
+    }
+
+    TEST_CASE("TrigramIndex_BruteForce")
+    {
+        std::mt19937 rng(47);
+        std::uniform_int_distribution<int> length(0, 40);
+        std::uniform_int_distribution<int> letter(0, 4);
+
+        std::vector<std::string> strings;
+        for (int i = 0; i < 2000; ++i)
+        {
+            std::string s;
+            for (int n = length(rng); n > 0; --n)
+            {
+                s += (char)("abcd\xE9"[letter(rng)]);
+            }
+            strings.push_back(s);
+        }
+
+        std::vector<StringSlice> docs = to_slices(strings);
+
+        TrigramIndex serial;
+        serial.build(docs.data(), docs.size());
+
+        ThreadPoolExecutor executor(4);
+        TrigramIndex parallel;
+        parallel.build(docs.data(), docs.size(), executor);
+
+        // The layout does not depend on how the work was split.
+        REQUIRE(serial.size_bytes() == parallel.size_bytes());
+        REQUIRE(memcmp(serial.data(), parallel.data(), serial.size_bytes()) == 0);
+
+        std::uniform_int_distribution<int> needle_length(1, 24);
+        for (int q = 0; q < 300; ++q)
+        {
+            // Half the needles come from the documents, so they match.
+            std::string needle;
+            if (q % 2 == 0)
+            {
+                const std::string& doc = strings[rng() % strings.size()];
+                size_t n = (size_t)needle_length(rng);
+                if (doc.size() < n)
+                {
+                    continue;
+                }
+                needle = doc.substr(rng() % (doc.size() - n + 1), n);
+            }
+            else
+            {
+                for (int n = needle_length(rng); n > 0; --n)
+                {
+                    needle += (char)("abcd\xE9"[letter(rng)]);
+                }
+            }
+
+            StringSlice key(needle.data(), (StringSlice::size_type)needle.size());
+            REQUIRE(find_docs(parallel, key, docs.data()) == scan_docs(key, docs));
+        }
+    }
+}
@@ -0,0 +1,194 @@
+#include "catch.hpp"
+
+#include "Utf8.h"
+
+namespace utf8_tests
+{
+    using namespace scottz0r;
+
+    // Reference validator that decodes one codepoint at a time.
+    static bool reference_valid(const StringSlice& slice)
+    {
+        StringSlice::size_type i = 0;
+        while (i < slice.size())
+        {
+            uint32_t cp;
+            unsigned int len = detail::utf8_decode(slice.data() + i, slice.size() - i, cp);
+            if (len == 0)
+            {
+                return false;
+            }
+
+            i += len;
+        }
+
+        return true;
+    }
+
+    TEST_CASE("Utf8_Validation")
+    {
+        SECTION("Valid")
+        {
+            REQUIRE(is_valid_utf8(""));
+            REQUIRE(is_valid_utf8("plain ascii text that is longer than one block of sixteen bytes"));
+            REQUIRE(is_valid_utf8("\xc3\xbc"));                  // U+00FC
+            REQUIRE(is_valid_utf8("\xe2\x82\xac"));              // U+20AC
+            REQUIRE(is_valid_utf8("\xf0\x9f\x98\x80"));          // U+1F600
+            REQUIRE(is_valid_utf8("\xf4\x8f\xbf\xbf"));          // U+10FFFF
+            REQUIRE(is_valid_utf8("\xed\x9f\xbf"));              // U+D7FF
+            REQUIRE(is_valid_utf8("0123456789abcd\xe2\x82\xac xyz")); // Sequence across a block boundary.
+        }
+
+        SECTION("Invalid")
+        {
+            REQUIRE_FALSE(is_valid_utf8("\x80"));                 // Lone continuation.
+            REQUIRE_FALSE(is_valid_utf8("\xc3"));                 // Truncated.
+            REQUIRE_FALSE(is_valid_utf8("\xc3x"));                // Too short.
+            REQUIRE_FALSE(is_valid_utf8("\xc0\xaf"));             // Overlong 2 byte.
+            REQUIRE_FALSE(is_valid_utf8("\xe0\x80\xaf"));         // Overlong 3 byte.
+            REQUIRE_FALSE(is_valid_utf8("\xf0\x80\x80\xaf"));     // Overlong 4 byte.
+            REQUIRE_FALSE(is_valid_utf8("\xed\xa0\x80"));         // Surrogate.
+            REQUIRE_FALSE(is_valid_utf8("\xf4\x90\x80\x80"));     // Above U+10FFFF.
+            REQUIRE_FALSE(is_valid_utf8("\xff"));
+            REQUIRE_FALSE(is_valid_utf8("\xe2\x82\xac\x80"));     // Too long.
+            REQUIRE_FALSE(is_valid_utf8("0123456789abcde\xe2"));  // Truncated at the end of a block.
+            REQUIRE_FALSE(is_valid_utf8("0123456789abcde\xe2" "0123456789abcdef"));
+        }
+
+        SECTION("Matches reference decoder")
+        {
+            // Random strings built from fragments that are likely to combine into edge cases.
+            const char* fragments[] = { "a", "abcdefgh", "\xc3\xbc", "\xe2\x82\xac", "\xf0\x9f\x98\x80", "\x80",
+                "\xc3", "\xe2\x82", "\xed\xa0\x80", "\xf4\x90", "\xc0\xaf", "\xff", "\xef\xbf\xbf" };
+            const unsigned int fragment_count = sizeof(fragments) / sizeof(fragments[0]);
+
+            uint32_t seed = 12345;
+            for (int iter = 0; iter < 2000; ++iter)
+            {
+                char buffer[128];
+                unsigned int n = 0;
+                unsigned int pieces = 1 + iter % 24;
+
+                for (unsigned int j = 0; j < pieces; ++j)
+                {
+                    seed = seed * 1103515245 + 12345;
+                    // Bias toward valid fragments so that some strings are valid.
+                    unsigned int pick = (seed >> 16) % (fragment_count * 3);
+                    StringSlice frag = fragments[pick < fragment_count * 2 ? pick % 5 : pick % fragment_count];
+                    n += frag.copy_to(buffer + n, sizeof(buffer) - n);
+                }
+
+                StringSlice slice(buffer, n);
+                REQUIRE(is_valid_utf8(slice) == reference_valid(slice));
+            }
+        }
+    }
+
+    TEST_CASE("Utf8_Length")
+    {
+        REQUIRE(utf8_length("") == 0);
+        REQUIRE(utf8_length("abc") == 3);
+        REQUIRE(utf8_length("\xc3\xbc\xe2\x82\xac\xf0\x9f\x98\x80") == 3);
+        REQUIRE(utf8_length("x\xc3\xbc long enough to use words \xe2\x82\xac") == 29);
+    }
+
+    TEST_CASE("Utf8_Iterator")
+    {
+        SECTION("Valid")
+        {
+            Utf8Iterator it("a\xc3\xbc\xe2\x82\xac\xf0\x9f\x98\x80");
+            uint32_t cp;
+
+            REQUIRE(it.next(cp));
+            REQUIRE(cp == 'a');
+            REQUIRE(it.next(cp));
+            REQUIRE(cp == 0xFC);
+            REQUIRE(it.next(cp));
+            REQUIRE(cp == 0x20AC);
+            REQUIRE(it.position() == 6);
+            REQUIRE(it.next(cp));
+            REQUIRE(cp == 0x1F600);
+            REQUIRE_FALSE(it.next(cp));
+        }
+
+        SECTION("Invalid")
+        {
+            Utf8Iterator it("\xe2\x82x");
+            uint32_t cp;
+
+            REQUIRE(it.next(cp));
+            REQUIRE(cp == utf8_replacement_char);
+            REQUIRE(it.next(cp));
+            REQUIRE(cp == utf8_replacement_char);
+            REQUIRE(it.next(cp));
+            REQUIRE(cp == 'x');
+            REQUIRE_FALSE(it.next(cp));
+        }
+    }
+
+    TEST_CASE("Utf8_Transcode")
+    {
+        StringSlice text = "ascii run of text \xc3\xbc\xe2\x82\xac\xf0\x9f\x98\x80!";
+
+        SECTION("UTF-8 to UTF-16 and back")
+        {
+            char16_t wide[64];
+            REQUIRE(utf16_length_from_utf8(text) == 23);
+
+            StringSlice::size_type n = transcode_utf8_to_utf16(text, wide, 64);
+            REQUIRE(n == 23);
+            REQUIRE(wide[0] == u'a');
+            REQUIRE(wide[18] == 0xFC);
+            REQUIRE(wide[19] == 0x20AC);
+            REQUIRE(wide[20] == 0xD83D);
+            REQUIRE(wide[21] == 0xDE00);
+            REQUIRE(wide[22] == u'!');
+
+            char narrow[64];
+            REQUIRE(utf8_length_from_utf16(wide, n) == text.size());
+            StringSlice::size_type m = transcode_utf16_to_utf8(wide, n, narrow, 64);
+            REQUIRE(StringSlice(narrow, m) == text);
+        }
+
+        SECTION("UTF-8 to UTF-32 and back")
+        {
+            char32_t wide[64];
+            StringSlice::size_type n = transcode_utf8_to_utf32(text, wide, 64);
+            REQUIRE(n == utf8_length(text));
+            REQUIRE(wide[20] == 0x1F600);
+
+            char narrow[64];
+            REQUIRE(utf8_length_from_utf32(wide, n) == text.size());
+            StringSlice::size_type m = transcode_utf32_to_utf8(wide, n, narrow, 64);
+            REQUIRE(StringSlice(narrow, m) == text);
+        }
+
+        SECTION("Output too small")
+        {
+            char16_t wide[21];
+            REQUIRE(transcode_utf8_to_utf16(text, wide, 21) == StringSlice::npos);
+
+            const char16_t in[] = { u'a', u'b', 0x20AC };
+            char narrow[4];
+            REQUIRE(transcode_utf16_to_utf8(in, 3, narrow, 4) == StringSlice::npos);
+            REQUIRE(transcode_utf16_to_utf8(in, 2, narrow, 4) == 2);
+        }
+
+        SECTION("Invalid input")
+        {
+            char16_t wide[16];
+            REQUIRE(transcode_utf8_to_utf16("abc\xed\xa0\x80", wide, 16) == StringSlice::npos);
+            REQUIRE(transcode_utf8_to_utf16("abcdefgh\xc3", wide, 16) == StringSlice::npos);
+
+            char narrow[16];
+            const char16_t lone_high[] = { u'a', 0xD800, u'b' };
+            const char16_t lone_low[] = { 0xDC00 };
+            REQUIRE(transcode_utf16_to_utf8(lone_high, 3, narrow, 16) == StringSlice::npos);
+            REQUIRE(transcode_utf16_to_utf8(lone_high, 2, narrow, 16) == StringSlice::npos);
+            REQUIRE(transcode_utf16_to_utf8(lone_low, 1, narrow, 16) == StringSlice::npos);
+
+            const char32_t too_large[] = { 0x110000 };
+            REQUIRE(transcode_utf32_to_utf8(too_large, 1, narrow, 16) == StringSlice::npos);
+        }
+    }
+}